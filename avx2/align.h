@@ -10,6 +10,12 @@
         __m256i vec[(N+31)/32]; \
     }
 
+#define ALIGNED_INT16(N)        \
+    union {                     \
+        int16_t coeffs[N];      \
+        __m256i vec[(N+15)/16]; \
+    }
+
 #define ALIGNED_INT32(N)        \
     union {                     \
         int32_t coeffs[N];      \
@@ -10,6 +10,12 @@
 #define _ZETAS_QINV  32
 #define _ZETAS      328
 
+#define _ZETAS512_QINV        0
+#define _ZETAS512           256
+#define _ZETAS512_INV_QINV  512
+#define _ZETAS512_INV       768
+#define _DIV512            1024
+
 /* The C ABI on MacOS exports all symbols with a leading
  * underscore. This means that any symbols we refer to from
  * C files (functions) can't be found, and all symbols we
@@ -34,5 +40,10 @@ typedef ALIGNED_INT32(624) qdata_t;
 #define qdata DILITHIUM_NAMESPACE(qdata)
 extern const qdata_t qdata;
 
+typedef ALIGNED_INT32(1028) qdata512_t;
+
+#define qdata512 DILITHIUM_NAMESPACE(qdata512)
+extern const qdata512_t qdata512;
+
 #endif
 #endif
@@ -0,0 +1 @@
+../ref/dbench.h
\ No newline at end of file
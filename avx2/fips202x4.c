@@ -4,6 +4,128 @@
 #include <string.h>
 #include "fips202.h"
 #include "fips202x4.h"
+#include "dbench.h"
+
+static void keccakx4_permute(__m256i s[25]) {
+  DBENCH_START();
+
+  f1600x4(s, KeccakF_RoundConstants);
+
+  DBENCH_STOP(*tkeccak);
+}
+
+static void keccakx4_permute_lanes(__m256i s[25], unsigned int lanes) {
+  unsigned int i;
+  __m256i t[25], mask;
+
+  if(lanes == 0xF) {
+    keccakx4_permute(s);
+    return;
+  }
+
+  /* Restore the lanes that must not be permuted */
+  mask = _mm256_set_epi64x(-(long long)((lanes >> 3) & 1), -(long long)((lanes >> 2) & 1),
+                           -(long long)((lanes >> 1) & 1), -(long long)(lanes & 1));
+  for(i = 0; i < 25; ++i)
+    t[i] = s[i];
+  keccakx4_permute(s);
+  for(i = 0; i < 25; ++i)
+    s[i] = _mm256_blendv_epi8(t[i], s[i], mask);
+}
+
+static void keccakx4_xor_lane(uint64_t t[25][4],
+                              unsigned int k,
+                              unsigned int pos,
+                              const uint8_t *in,
+                              unsigned int inlen)
+{
+  unsigned int i;
+  uint64_t w;
+
+  for(i = 0; i < inlen && (pos + i) % 8; ++i)
+    t[(pos + i)/8][k] ^= (uint64_t)in[i] << 8*((pos + i) % 8);
+  for(; i + 8 <= inlen; i += 8) {
+    memcpy(&w, in + i, 8);
+    t[(pos + i)/8][k] ^= w;
+  }
+  for(; i < inlen; ++i)
+    t[(pos + i)/8][k] ^= (uint64_t)in[i] << 8*((pos + i) % 8);
+}
+
+static void keccakx4_init(__m256i s[25], unsigned int pos[4])
+{
+  unsigned int i;
+
+  for(i = 0; i < 25; ++i)
+    s[i] = _mm256_setzero_si256();
+  for(i = 0; i < 4; ++i)
+    pos[i] = 0;
+}
+
+static void keccakx4_absorb(__m256i s[25],
+                            unsigned int pos[4],
+                            unsigned int r,
+                            const uint8_t *const in[4],
+                            const size_t inlen[4])
+{
+  unsigned int i, k, n, full;
+  size_t len[4];
+  const uint8_t *p[4];
+  uint64_t t[25][4];
+
+  for(k = 0; k < 4; ++k) {
+    p[k] = in[k];
+    len[k] = inlen[k];
+  }
+
+  /* Each round fills the current block of every lane as far as its input
+   * reaches; only lanes with a full block are permuted */
+  for(;;) {
+    for(i = 0; i < r/8; ++i)
+      _mm256_storeu_si256((__m256i *)t[i], s[i]);
+
+    full = 0;
+    for(k = 0; k < 4; ++k) {
+      n = r - pos[k];
+      if(n > len[k])
+        n = len[k];
+      keccakx4_xor_lane(t, k, pos[k], p[k], n);
+      pos[k] += n;
+      p[k] += n;
+      len[k] -= n;
+      if(pos[k] == r)
+        full |= 1 << k;
+    }
+
+    for(i = 0; i < r/8; ++i)
+      s[i] = _mm256_loadu_si256((__m256i *)t[i]);
+
+    if(!full)
+      break;
+
+    keccakx4_permute_lanes(s, full);
+    for(k = 0; k < 4; ++k)
+      if(full & (1 << k))
+        pos[k] = 0;
+  }
+}
+
+static void keccakx4_finalize(__m256i s[25], unsigned int pos[4], unsigned int r, uint8_t p)
+{
+  unsigned int k;
+  uint64_t t[25][4];
+  const uint8_t pad = 0x80;
+
+  for(k = 0; k < r/8; ++k)
+    _mm256_storeu_si256((__m256i *)t[k], s[k]);
+  for(k = 0; k < 4; ++k) {
+    keccakx4_xor_lane(t, k, pos[k], &p, 1);
+    keccakx4_xor_lane(t, k, r - 1, &pad, 1);
+    pos[k] = r;
+  }
+  for(k = 0; k < r/8; ++k)
+    s[k] = _mm256_loadu_si256((__m256i *)t[k]);
+}
 
 static void keccakx4_absorb_once(__m256i s[25],
                                  unsigned int r,
@@ -30,7 +152,7 @@ static void keccakx4_absorb_once(__m256i s[25],
     }
     inlen -= r;
 
-    f1600x4(s, KeccakF_RoundConstants);
+    keccakx4_permute(s);
   }
 
   for(i = 0; i < inlen/8; ++i) {
@@ -65,7 +187,7 @@ static void keccakx4_squeezeblocks(uint8_t *out0,
   __m128d t;
 
   while(nblocks > 0) {
-    f1600x4(s, KeccakF_RoundConstants);
+    keccakx4_permute(s);
     for(i=0; i < r/8; ++i) {
       t = _mm_castsi128_pd(_mm256_castsi256_si128(s[i]));
       _mm_storel_pd((__attribute__((__may_alias__)) double *)&out0[8*i], t);
@@ -83,6 +205,69 @@ static void keccakx4_squeezeblocks(uint8_t *out0,
   }
 }
 
+static void keccakx4_squeeze(uint8_t *const out[4],
+                             const size_t outlen[4],
+                             unsigned int r,
+                             __m256i s[25],
+                             unsigned int pos[4])
+{
+  unsigned int i, k, n, lanes;
+  size_t len[4];
+  uint8_t *o[4];
+  uint64_t t[25][4];
+
+  for(k = 0; k < 4; ++k) {
+    o[k] = out[k];
+    len[k] = outlen[k];
+  }
+
+  for(;;) {
+    for(i = 0; i < r/8; ++i)
+      _mm256_storeu_si256((__m256i *)t[i], s[i]);
+
+    for(k = 0; k < 4; ++k) {
+      n = r - pos[k];
+      if(n > len[k])
+        n = len[k];
+      for(i = pos[k]; i < pos[k] + n; ++i)
+        *o[k]++ = t[i/8][k] >> 8*(i%8);
+      pos[k] += n;
+      len[k] -= n;
+    }
+
+    /* Only lanes that need more output are permuted, so every lane
+     * continues its own output stream in later calls */
+    lanes = 0;
+    for(k = 0; k < 4; ++k)
+      if(len[k])
+        lanes |= 1 << k;
+    if(!lanes)
+      break;
+
+    keccakx4_permute_lanes(s, lanes);
+    for(k = 0; k < 4; ++k)
+      if(lanes & (1 << k))
+        pos[k] = 0;
+  }
+}
+
+void shake128x4_init(keccakx4_state *state)
+{
+  keccakx4_init(state->s, state->pos);
+}
+
+void shake128x4_absorb(keccakx4_state *state,
+                       const uint8_t *const in[4],
+                       const size_t inlen[4])
+{
+  keccakx4_absorb(state->s, state->pos, SHAKE128_RATE, in, inlen);
+}
+
+void shake128x4_finalize(keccakx4_state *state)
+{
+  keccakx4_finalize(state->s, state->pos, SHAKE128_RATE, 0x1F);
+}
+
 void shake128x4_absorb_once(keccakx4_state *state,
                             const uint8_t *in0,
                             const uint8_t *in1,
@@ -91,6 +276,7 @@ void shake128x4_absorb_once(keccakx4_state *state,
                             size_t inlen)
 {
   keccakx4_absorb_once(state->s, SHAKE128_RATE, in0, in1, in2, in3, inlen, 0x1F);
+  state->pos[0] = state->pos[1] = state->pos[2] = state->pos[3] = SHAKE128_RATE;
 }
 
 void shake128x4_squeezeblocks(uint8_t *out0,
@@ -101,6 +287,31 @@ void shake128x4_squeezeblocks(uint8_t *out0,
                               keccakx4_state *state)
 {
   keccakx4_squeezeblocks(out0, out1, out2, out3, nblocks, SHAKE128_RATE, state->s);
+  state->pos[0] = state->pos[1] = state->pos[2] = state->pos[3] = SHAKE128_RATE;
+}
+
+void shake128x4_squeeze(uint8_t *const out[4],
+                        const size_t outlen[4],
+                        keccakx4_state *state)
+{
+  keccakx4_squeeze(out, outlen, SHAKE128_RATE, state->s, state->pos);
+}
+
+void shake256x4_init(keccakx4_state *state)
+{
+  keccakx4_init(state->s, state->pos);
+}
+
+void shake256x4_absorb(keccakx4_state *state,
+                       const uint8_t *const in[4],
+                       const size_t inlen[4])
+{
+  keccakx4_absorb(state->s, state->pos, SHAKE256_RATE, in, inlen);
+}
+
+void shake256x4_finalize(keccakx4_state *state)
+{
+  keccakx4_finalize(state->s, state->pos, SHAKE256_RATE, 0x1F);
 }
 
 void shake256x4_absorb_once(keccakx4_state *state,
@@ -111,6 +322,7 @@ void shake256x4_absorb_once(keccakx4_state *state,
                             size_t inlen)
 {
   keccakx4_absorb_once(state->s, SHAKE256_RATE, in0, in1, in2, in3, inlen, 0x1F);
+  state->pos[0] = state->pos[1] = state->pos[2] = state->pos[3] = SHAKE256_RATE;
 }
 
 void shake256x4_squeezeblocks(uint8_t *out0,
@@ -121,6 +333,14 @@ void shake256x4_squeezeblocks(uint8_t *out0,
                               keccakx4_state *state)
 {
   keccakx4_squeezeblocks(out0, out1, out2, out3, nblocks, SHAKE256_RATE, state->s);
+  state->pos[0] = state->pos[1] = state->pos[2] = state->pos[3] = SHAKE256_RATE;
+}
+
+void shake256x4_squeeze(uint8_t *const out[4],
+                        const size_t outlen[4],
+                        keccakx4_state *state)
+{
+  keccakx4_squeeze(out, outlen, SHAKE256_RATE, state->s, state->pos);
 }
 
 void shake128x4(uint8_t *out0,
@@ -194,3 +414,16 @@ void shake256x4(uint8_t *out0,
     }
   }
 }
+
+void sha3_256x4(uint8_t *const h[4],
+                const uint8_t *const in[4],
+                const size_t inlen[4])
+{
+  const size_t outlen[4] = {32, 32, 32, 32};
+  keccakx4_state state;
+
+  keccakx4_init(state.s, state.pos);
+  keccakx4_absorb(state.s, state.pos, SHA3_256_RATE, in, inlen);
+  keccakx4_finalize(state.s, state.pos, SHA3_256_RATE, 0x06);
+  keccakx4_squeeze(h, outlen, SHA3_256_RATE, state.s, state.pos);
+}
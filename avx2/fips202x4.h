@@ -26,11 +26,24 @@
 
 typedef struct {
   __m256i s[25];
+  /* Per-lane position in the current block */
+  unsigned int pos[4];
 } keccakx4_state;
 
 #define f1600x4 FIPS202X4_NAMESPACE(f1600x4)
 void f1600x4(__m256i *s, const uint64_t *rc);
 
+#define shake128x4_init FIPS202X4_NAMESPACE(shake128x4_init)
+void shake128x4_init(keccakx4_state *state);
+
+#define shake128x4_absorb FIPS202X4_NAMESPACE(shake128x4_absorb)
+void shake128x4_absorb(keccakx4_state *state,
+                       const uint8_t *const in[4],
+                       const size_t inlen[4]);
+
+#define shake128x4_finalize FIPS202X4_NAMESPACE(shake128x4_finalize)
+void shake128x4_finalize(keccakx4_state *state);
+
 #define shake128x4_absorb_once FIPS202X4_NAMESPACE(shake128x4_absorb_once)
 void shake128x4_absorb_once(keccakx4_state *state,
                             const uint8_t *in0,
@@ -47,6 +60,22 @@ void shake128x4_squeezeblocks(uint8_t *out0,
                               size_t nblocks,
                               keccakx4_state *state);
 
+#define shake128x4_squeeze FIPS202X4_NAMESPACE(shake128x4_squeeze)
+void shake128x4_squeeze(uint8_t *const out[4],
+                        const size_t outlen[4],
+                        keccakx4_state *state);
+
+#define shake256x4_init FIPS202X4_NAMESPACE(shake256x4_init)
+void shake256x4_init(keccakx4_state *state);
+
+#define shake256x4_absorb FIPS202X4_NAMESPACE(shake256x4_absorb)
+void shake256x4_absorb(keccakx4_state *state,
+                       const uint8_t *const in[4],
+                       const size_t inlen[4]);
+
+#define shake256x4_finalize FIPS202X4_NAMESPACE(shake256x4_finalize)
+void shake256x4_finalize(keccakx4_state *state);
+
 #define shake256x4_absorb_once FIPS202X4_NAMESPACE(shake256x4_absorb_once)
 void shake256x4_absorb_once(keccakx4_state *state,
                             const uint8_t *in0,
@@ -63,6 +92,11 @@ void shake256x4_squeezeblocks(uint8_t *out0,
                               size_t nblocks,
                               keccakx4_state *state);
 
+#define shake256x4_squeeze FIPS202X4_NAMESPACE(shake256x4_squeeze)
+void shake256x4_squeeze(uint8_t *const out[4],
+                        const size_t outlen[4],
+                        keccakx4_state *state);
+
 #define shake128x4 FIPS202X4_NAMESPACE(shake128x4)
 void shake128x4(uint8_t *out0,
                 uint8_t *out1,
@@ -87,5 +121,10 @@ void shake256x4(uint8_t *out0,
                 const uint8_t *in3,
                 size_t inlen);
 
+#define sha3_256x4 FIPS202X4_NAMESPACE(sha3_256x4)
+void sha3_256x4(uint8_t *const h[4],
+                const uint8_t *const in[4],
+                const size_t inlen[4]);
+
 #endif
 #endif
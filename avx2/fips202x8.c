@@ -0,0 +1,258 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <immintrin.h>
+#include "fips202.h"
+#include "fips202x8.h"
+#include "dbench.h"
+
+/* 8-way Keccak on AVX-512. All functions here are compiled for AVX-512F
+ * regardless of the build flags and must only be called after
+ * fips202x8_available() returned 1. */
+#define AVX512 __attribute__((target("avx512f")))
+
+#define ROL(a, offset) _mm512_rol_epi64(a, offset)
+#define XOR5(a, b, c, d, e) _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a, b, c, 0x96), d, e, 0x96)
+/* a ^ (~b & c) */
+#define CHI(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xD2)
+
+int fips202x8_available(void) {
+#ifdef DILITHIUM_NO_AVX512
+  return 0;
+#else
+  return __builtin_cpu_supports("avx512f");
+#endif
+}
+
+AVX512 static void f1600x8(__m512i s[25]) {
+  unsigned int round;
+  __m512i Aba, Abe, Abi, Abo, Abu;
+  __m512i Aga, Age, Agi, Ago, Agu;
+  __m512i Aka, Ake, Aki, Ako, Aku;
+  __m512i Ama, Ame, Ami, Amo, Amu;
+  __m512i Asa, Ase, Asi, Aso, Asu;
+  __m512i Bba, Bbe, Bbi, Bbo, Bbu;
+  __m512i Bga, Bge, Bgi, Bgo, Bgu;
+  __m512i Bka, Bke, Bki, Bko, Bku;
+  __m512i Bma, Bme, Bmi, Bmo, Bmu;
+  __m512i Bsa, Bse, Bsi, Bso, Bsu;
+  __m512i Ca, Ce, Ci, Co, Cu;
+  __m512i Da, De, Di, Do, Du;
+  DBENCH_START();
+
+  Aba = s[0];
+  Abe = s[1];
+  Abi = s[2];
+  Abo = s[3];
+  Abu = s[4];
+  Aga = s[5];
+  Age = s[6];
+  Agi = s[7];
+  Ago = s[8];
+  Agu = s[9];
+  Aka = s[10];
+  Ake = s[11];
+  Aki = s[12];
+  Ako = s[13];
+  Aku = s[14];
+  Ama = s[15];
+  Ame = s[16];
+  Ami = s[17];
+  Amo = s[18];
+  Amu = s[19];
+  Asa = s[20];
+  Ase = s[21];
+  Asi = s[22];
+  Aso = s[23];
+  Asu = s[24];
+
+  for(round = 0; round < 24; ++round) {
+    /* theta */
+    Ca = XOR5(Aba, Aga, Aka, Ama, Asa);
+    Ce = XOR5(Abe, Age, Ake, Ame, Ase);
+    Ci = XOR5(Abi, Agi, Aki, Ami, Asi);
+    Co = XOR5(Abo, Ago, Ako, Amo, Aso);
+    Cu = XOR5(Abu, Agu, Aku, Amu, Asu);
+    Da = _mm512_xor_si512(Cu, ROL(Ce, 1));
+    De = _mm512_xor_si512(Ca, ROL(Ci, 1));
+    Di = _mm512_xor_si512(Ce, ROL(Co, 1));
+    Do = _mm512_xor_si512(Ci, ROL(Cu, 1));
+    Du = _mm512_xor_si512(Co, ROL(Ca, 1));
+
+    /* rho and pi */
+    Bba = _mm512_xor_si512(Aba, Da);
+    Bme = ROL(_mm512_xor_si512(Aga, Da), 36);
+    Bgi = ROL(_mm512_xor_si512(Aka, Da), 3);
+    Bso = ROL(_mm512_xor_si512(Ama, Da), 41);
+    Bku = ROL(_mm512_xor_si512(Asa, Da), 18);
+    Bka = ROL(_mm512_xor_si512(Abe, De), 1);
+    Bbe = ROL(_mm512_xor_si512(Age, De), 44);
+    Bmi = ROL(_mm512_xor_si512(Ake, De), 10);
+    Bgo = ROL(_mm512_xor_si512(Ame, De), 45);
+    Bsu = ROL(_mm512_xor_si512(Ase, De), 2);
+    Bsa = ROL(_mm512_xor_si512(Abi, Di), 62);
+    Bke = ROL(_mm512_xor_si512(Agi, Di), 6);
+    Bbi = ROL(_mm512_xor_si512(Aki, Di), 43);
+    Bmo = ROL(_mm512_xor_si512(Ami, Di), 15);
+    Bgu = ROL(_mm512_xor_si512(Asi, Di), 61);
+    Bga = ROL(_mm512_xor_si512(Abo, Do), 28);
+    Bse = ROL(_mm512_xor_si512(Ago, Do), 55);
+    Bki = ROL(_mm512_xor_si512(Ako, Do), 25);
+    Bbo = ROL(_mm512_xor_si512(Amo, Do), 21);
+    Bmu = ROL(_mm512_xor_si512(Aso, Do), 56);
+    Bma = ROL(_mm512_xor_si512(Abu, Du), 27);
+    Bge = ROL(_mm512_xor_si512(Agu, Du), 20);
+    Bsi = ROL(_mm512_xor_si512(Aku, Du), 39);
+    Bko = ROL(_mm512_xor_si512(Amu, Du), 8);
+    Bbu = ROL(_mm512_xor_si512(Asu, Du), 14);
+
+    /* chi and iota */
+    Aba = CHI(Bba, Bbe, Bbi);
+    Abe = CHI(Bbe, Bbi, Bbo);
+    Abi = CHI(Bbi, Bbo, Bbu);
+    Abo = CHI(Bbo, Bbu, Bba);
+    Abu = CHI(Bbu, Bba, Bbe);
+    Aga = CHI(Bga, Bge, Bgi);
+    Age = CHI(Bge, Bgi, Bgo);
+    Agi = CHI(Bgi, Bgo, Bgu);
+    Ago = CHI(Bgo, Bgu, Bga);
+    Agu = CHI(Bgu, Bga, Bge);
+    Aka = CHI(Bka, Bke, Bki);
+    Ake = CHI(Bke, Bki, Bko);
+    Aki = CHI(Bki, Bko, Bku);
+    Ako = CHI(Bko, Bku, Bka);
+    Aku = CHI(Bku, Bka, Bke);
+    Ama = CHI(Bma, Bme, Bmi);
+    Ame = CHI(Bme, Bmi, Bmo);
+    Ami = CHI(Bmi, Bmo, Bmu);
+    Amo = CHI(Bmo, Bmu, Bma);
+    Amu = CHI(Bmu, Bma, Bme);
+    Asa = CHI(Bsa, Bse, Bsi);
+    Ase = CHI(Bse, Bsi, Bso);
+    Asi = CHI(Bsi, Bso, Bsu);
+    Aso = CHI(Bso, Bsu, Bsa);
+    Asu = CHI(Bsu, Bsa, Bse);
+    Aba = _mm512_xor_si512(Aba, _mm512_set1_epi64(KeccakF_RoundConstants[round]));
+  }
+
+  s[0] = Aba;
+  s[1] = Abe;
+  s[2] = Abi;
+  s[3] = Abo;
+  s[4] = Abu;
+  s[5] = Aga;
+  s[6] = Age;
+  s[7] = Agi;
+  s[8] = Ago;
+  s[9] = Agu;
+  s[10] = Aka;
+  s[11] = Ake;
+  s[12] = Aki;
+  s[13] = Ako;
+  s[14] = Aku;
+  s[15] = Ama;
+  s[16] = Ame;
+  s[17] = Ami;
+  s[18] = Amo;
+  s[19] = Amu;
+  s[20] = Asa;
+  s[21] = Ase;
+  s[22] = Asi;
+  s[23] = Aso;
+  s[24] = Asu;
+
+  DBENCH_STOP(*tkeccak);
+}
+
+AVX512 static void keccakx8_absorb_once(__m512i s[25],
+                                        unsigned int r,
+                                        const uint8_t *const in[8],
+                                        size_t inlen,
+                                        uint8_t p)
+{
+  unsigned int i, j, k;
+  uint64_t pos = 0;
+  uint64_t w[8];
+  __m512i t, idx;
+
+  for(i = 0; i < 25; ++i)
+    s[i] = _mm512_setzero_si512();
+
+  idx = _mm512_set_epi64((long long)in[7], (long long)in[6], (long long)in[5], (long long)in[4],
+                         (long long)in[3], (long long)in[2], (long long)in[1], (long long)in[0]);
+  while(inlen >= r) {
+    for(i = 0; i < r/8; ++i) {
+      t = _mm512_i64gather_epi64(idx, (long long *)pos, 1);
+      s[i] = _mm512_xor_si512(s[i], t);
+      pos += 8;
+    }
+    inlen -= r;
+
+    f1600x8(s);
+  }
+
+  for(i = 0; i < inlen/8; ++i) {
+    t = _mm512_i64gather_epi64(idx, (long long *)pos, 1);
+    s[i] = _mm512_xor_si512(s[i], t);
+    pos += 8;
+  }
+  inlen -= 8*i;
+
+  /* Last partial word is copied so that no lane is read past its end */
+  for(k = 0; k < 8; ++k) {
+    w[k] = (uint64_t)p << 8*inlen;
+    for(j = 0; j < inlen; ++j)
+      w[k] ^= (uint64_t)in[k][pos + j] << 8*j;
+  }
+  s[i] = _mm512_xor_si512(s[i], _mm512_loadu_si512(w));
+  t = _mm512_set1_epi64(1ULL << 63);
+  s[r/8 - 1] = _mm512_xor_si512(s[r/8 - 1], t);
+}
+
+AVX512 static void keccakx8_squeezeblocks(uint8_t *const out[8],
+                                          size_t nblocks,
+                                          unsigned int r,
+                                          __m512i s[25])
+{
+  unsigned int i;
+  uint64_t pos = 0;
+  __m512i idx;
+
+  idx = _mm512_set_epi64((long long)out[7], (long long)out[6], (long long)out[5], (long long)out[4],
+                         (long long)out[3], (long long)out[2], (long long)out[1], (long long)out[0]);
+  while(nblocks > 0) {
+    f1600x8(s);
+    for(i = 0; i < r/8; ++i) {
+      _mm512_i64scatter_epi64((long long *)pos, idx, s[i], 1);
+      pos += 8;
+    }
+    --nblocks;
+  }
+}
+
+AVX512 void shake128x8_absorb_once(keccakx8_state *state,
+                                   const uint8_t *const in[8],
+                                   size_t inlen)
+{
+  keccakx8_absorb_once(state->s, SHAKE128_RATE, in, inlen, 0x1F);
+}
+
+AVX512 void shake128x8_squeezeblocks(uint8_t *const out[8],
+                                     size_t nblocks,
+                                     keccakx8_state *state)
+{
+  keccakx8_squeezeblocks(out, nblocks, SHAKE128_RATE, state->s);
+}
+
+AVX512 void shake256x8_absorb_once(keccakx8_state *state,
+                                   const uint8_t *const in[8],
+                                   size_t inlen)
+{
+  keccakx8_absorb_once(state->s, SHAKE256_RATE, in, inlen, 0x1F);
+}
+
+AVX512 void shake256x8_squeezeblocks(uint8_t *const out[8],
+                                     size_t nblocks,
+                                     keccakx8_state *state)
+{
+  keccakx8_squeezeblocks(out, nblocks, SHAKE256_RATE, state->s);
+}
@@ -0,0 +1,39 @@
+#ifndef FIPS202X8_H
+#define FIPS202X8_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+#define FIPS202X8_NAMESPACE(s) pqcrystals_dilithium_fips202x8_avx2_##s
+
+typedef struct {
+  __m512i s[25];
+} keccakx8_state;
+
+/* Returns 1 if the CPU supports AVX-512F; always 0 if the build defines
+ * DILITHIUM_NO_AVX512, which forces the AVX2 code paths */
+#define fips202x8_available FIPS202X8_NAMESPACE(available)
+int fips202x8_available(void);
+
+#define shake128x8_absorb_once FIPS202X8_NAMESPACE(shake128x8_absorb_once)
+void shake128x8_absorb_once(keccakx8_state *state,
+                            const uint8_t *const in[8],
+                            size_t inlen);
+
+#define shake128x8_squeezeblocks FIPS202X8_NAMESPACE(shake128x8_squeezeblocks)
+void shake128x8_squeezeblocks(uint8_t *const out[8],
+                              size_t nblocks,
+                              keccakx8_state *state);
+
+#define shake256x8_absorb_once FIPS202X8_NAMESPACE(shake256x8_absorb_once)
+void shake256x8_absorb_once(keccakx8_state *state,
+                            const uint8_t *const in[8],
+                            size_t inlen);
+
+#define shake256x8_squeezeblocks FIPS202X8_NAMESPACE(shake256x8_squeezeblocks)
+void shake256x8_squeezeblocks(uint8_t *const out[8],
+                              size_t nblocks,
+                              keccakx8_state *state);
+
+#endif
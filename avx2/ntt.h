@@ -1,7 +1,9 @@
 #ifndef NTT_H
 #define NTT_H
 
+#include <stdint.h>
 #include <immintrin.h>
+#include "params.h"
 
 #define ntt_avx DILITHIUM_NAMESPACE(ntt_avx)
 void ntt_avx(__m256i *a, const __m256i *qdata);
@@ -16,4 +18,16 @@ void pointwise_avx(__m256i *c, const __m256i *a, const __m256i *b, const __m256i
 #define pointwise_acc_avx DILITHIUM_NAMESPACE(pointwise_acc_avx)
 void pointwise_acc_avx(__m256i *c, const __m256i *a, const __m256i *b, const __m256i *qdata);
 
+#define ntt_avx512 DILITHIUM_NAMESPACE(ntt_avx512)
+void ntt_avx512(int32_t a[N]);
+#define invntt_avx512 DILITHIUM_NAMESPACE(invntt_avx512)
+void invntt_avx512(int32_t a[N]);
+#define pointwise_avx512 DILITHIUM_NAMESPACE(pointwise_avx512)
+void pointwise_avx512(int32_t c[N], const int32_t a[N], const int32_t b[N]);
+#define pointwise_acc_avx512 DILITHIUM_NAMESPACE(pointwise_acc_avx512)
+void pointwise_acc_avx512(int32_t c[N], const int32_t a[L*N], const int32_t b[L*N]);
+#define pointwise_acc_invntt_avx512 DILITHIUM_NAMESPACE(pointwise_acc_invntt_avx512)
+void pointwise_acc_invntt_avx512(int32_t c[N], const int32_t a[L*N], const int32_t b[L*N],
+                                 const int32_t d[N], const int32_t e[N]);
+
 #endif
@@ -0,0 +1,376 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <immintrin.h>
+#include "params.h"
+#include "consts.h"
+#include "ntt.h"
+
+/* NTT, inverse NTT and pointwise multiplication on AVX-512. A polynomial
+ * fills 16 ZMM registers, so all eight layers run without storing
+ * intermediate results. The NTT domain uses the same coefficient order as
+ * ntt.S, so both implementations can be mixed freely. All functions here
+ * are compiled for AVX-512F regardless of the build flags and must only be
+ * called after fips202x8_available() returned 1, which is the one run-time
+ * AVX-512 check of this build. */
+#define AVX512 __attribute__((target("avx512f")))
+
+/* Montgomery reduction of the signed 64-bit products in the even lanes of
+ * e and the odd lanes of o; only the low 32 bits of each product are
+ * needed for the quotient */
+AVX512 static inline __m512i montred(__m512i e, __m512i o) {
+  const __m512i q = _mm512_set1_epi32(Q);
+  const __m512i qinv = _mm512_set1_epi32(qdata.coeffs[_8XQINV]);
+  __m512i te, to;
+
+  te = _mm512_mul_epi32(e, qinv);
+  to = _mm512_mul_epi32(o, qinv);
+  te = _mm512_mul_epi32(te, q);
+  to = _mm512_mul_epi32(to, q);
+  e = _mm512_sub_epi64(e, te);
+  o = _mm512_sub_epi64(o, to);
+  return _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(e, 32), o);
+}
+
+/* a*z*2^{-32} for zq = z*QINV mod 2^32 */
+AVX512 static inline __m512i fqmul(__m512i a, __m512i z, __m512i zq) {
+  const __m512i q = _mm512_set1_epi32(Q);
+  __m512i ao, zo, zqo, e, o, te, to;
+
+  ao = _mm512_srli_epi64(a, 32);
+  zo = _mm512_srli_epi64(z, 32);
+  zqo = _mm512_srli_epi64(zq, 32);
+  te = _mm512_mul_epi32(a, zq);
+  to = _mm512_mul_epi32(ao, zqo);
+  e = _mm512_mul_epi32(a, z);
+  o = _mm512_mul_epi32(ao, zo);
+  te = _mm512_mul_epi32(te, q);
+  to = _mm512_mul_epi32(to, q);
+  e = _mm512_sub_epi64(e, te);
+  o = _mm512_sub_epi64(o, to);
+  return _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(e, 32), o);
+}
+
+/* Cooley-Tukey butterfly */
+AVX512 static inline void ct(__m512i *a, __m512i *b, __m512i z, __m512i zq) {
+  __m512i t;
+
+  t = fqmul(*b, z, zq);
+  *b = _mm512_sub_epi32(*a, t);
+  *a = _mm512_add_epi32(*a, t);
+}
+
+/* Gentleman-Sande butterfly */
+AVX512 static inline void gs(__m512i *a, __m512i *b, __m512i z, __m512i zq) {
+  __m512i t;
+
+  t = _mm512_sub_epi32(*a, *b);
+  *a = _mm512_add_epi32(*a, *b);
+  *b = fqmul(t, z, zq);
+}
+
+/* Each group of 16 >> s lanes gets one of the twiddle factors starting
+ * at qdata512[off] */
+#define ZETAS(off, s) \
+  _mm512_permutexvar_epi32(_mm512_srli_epi32(iota, s), \
+                           _mm512_loadu_si512(&qdata512.coeffs[off]))
+
+/* Merging register pairs for layers 5 to 8 */
+#define IDX_128 _mm512_setr_epi64(0, 1, 8, 9, 4, 5, 12, 13)
+#define IDX_128H _mm512_setr_epi64(2, 3, 10, 11, 6, 7, 14, 15)
+/* Transposition of 8x8 blocks into the order of ntt.S */
+#define IDX_T0 _mm512_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28, \
+                                 1, 5, 9, 13, 17, 21, 25, 29)
+#define IDX_T1 _mm512_setr_epi32(2, 6, 10, 14, 18, 22, 26, 30, \
+                                 3, 7, 11, 15, 19, 23, 27, 31)
+#define IDX_U0 _mm512_setr_epi32(0, 8, 16, 24, 1, 9, 17, 25, \
+                                 2, 10, 18, 26, 3, 11, 19, 27)
+#define IDX_U1 _mm512_setr_epi32(4, 12, 20, 28, 5, 13, 21, 29, \
+                                 6, 14, 22, 30, 7, 15, 23, 31)
+
+/*************************************************
+* Name:        ntt_avx512
+*
+* Description: Forward NTT, in-place. No modular reduction is performed after
+*              additions or subtractions. Output coefficients are in the
+*              order of ntt_avx and can grow by up to 8*Q in absolute value.
+*
+* Arguments:   - int32_t a[N]: input/output coefficient array
+**************************************************/
+AVX512 void ntt_avx512(int32_t a[N]) {
+  unsigned int i, j;
+  const __m512i iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                         8, 9, 10, 11, 12, 13, 14, 15);
+  __m512i r[16], x, y, t, z, zq;
+
+  for(i = 0; i < 16; ++i)
+    r[i] = _mm512_loadu_si512(&a[16*i]);
+
+  /* layers 1 to 4 work on whole registers */
+  z = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512 + 1]);
+  zq = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_QINV + 1]);
+  for(i = 0; i < 8; ++i)
+    ct(&r[i], &r[i+8], z, zq);
+
+  for(i = 0; i < 2; ++i) {
+    z = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512 + 2 + i]);
+    zq = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_QINV + 2 + i]);
+    for(j = 0; j < 4; ++j)
+      ct(&r[8*i+j], &r[8*i+j+4], z, zq);
+  }
+
+  for(i = 0; i < 4; ++i) {
+    z = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512 + 4 + i]);
+    zq = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_QINV + 4 + i]);
+    for(j = 0; j < 2; ++j)
+      ct(&r[4*i+j], &r[4*i+j+2], z, zq);
+  }
+
+  for(i = 0; i < 8; ++i) {
+    z = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512 + 8 + i]);
+    zq = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_QINV + 8 + i]);
+    ct(&r[2*i], &r[2*i+1], z, zq);
+  }
+
+  /* layers 5 to 8 on pairs of registers, each layer moves the butterfly
+   * partners of the next one into opposite registers */
+  for(i = 0; i < 8; ++i) {
+    x = _mm512_shuffle_i64x2(r[2*i], r[2*i+1], 0x44);
+    y = _mm512_shuffle_i64x2(r[2*i], r[2*i+1], 0xEE);
+    ct(&x, &y, ZETAS(_ZETAS512 + 16 + 2*i, 3),
+       ZETAS(_ZETAS512_QINV + 16 + 2*i, 3));
+
+    t = _mm512_permutex2var_epi64(x, IDX_128, y);
+    y = _mm512_permutex2var_epi64(x, IDX_128H, y);
+    ct(&t, &y, ZETAS(_ZETAS512 + 32 + 4*i, 2),
+       ZETAS(_ZETAS512_QINV + 32 + 4*i, 2));
+
+    x = _mm512_unpacklo_epi64(t, y);
+    y = _mm512_unpackhi_epi64(t, y);
+    ct(&x, &y, ZETAS(_ZETAS512 + 64 + 8*i, 1),
+       ZETAS(_ZETAS512_QINV + 64 + 8*i, 1));
+
+    t = _mm512_mask_blend_epi32(0xAAAA, x, _mm512_slli_epi64(y, 32));
+    y = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(x, 32), y);
+    ct(&t, &y, _mm512_loadu_si512(&qdata512.coeffs[_ZETAS512 + 128 + 16*i]),
+       _mm512_loadu_si512(&qdata512.coeffs[_ZETAS512_QINV + 128 + 16*i]));
+
+    /* even and odd coefficients */
+    r[2*i] = t;
+    r[2*i+1] = y;
+  }
+
+  for(i = 0; i < 4; ++i) {
+    x = _mm512_permutex2var_epi32(r[4*i], IDX_T0, r[4*i+2]);
+    y = _mm512_permutex2var_epi32(r[4*i+1], IDX_T0, r[4*i+3]);
+    _mm512_storeu_si512(&a[64*i], _mm512_shuffle_i64x2(x, y, 0x44));
+    _mm512_storeu_si512(&a[64*i+16], _mm512_shuffle_i64x2(x, y, 0xEE));
+    x = _mm512_permutex2var_epi32(r[4*i], IDX_T1, r[4*i+2]);
+    y = _mm512_permutex2var_epi32(r[4*i+1], IDX_T1, r[4*i+3]);
+    _mm512_storeu_si512(&a[64*i+32], _mm512_shuffle_i64x2(x, y, 0x44));
+    _mm512_storeu_si512(&a[64*i+48], _mm512_shuffle_i64x2(x, y, 0xEE));
+  }
+}
+
+/* Deinterleaves 64 coefficients in the order of ntt.S into the even and
+ * odd coefficients of two blocks of 32 */
+AVX512 static inline void deinterleave(__m512i r[4], __m512i x, __m512i y,
+                                       __m512i u, __m512i v) {
+  __m512i t;
+
+  t = _mm512_shuffle_i64x2(x, y, 0x44);
+  y = _mm512_shuffle_i64x2(x, y, 0xEE);
+  x = _mm512_shuffle_i64x2(u, v, 0x44);
+  v = _mm512_shuffle_i64x2(u, v, 0xEE);
+  r[0] = _mm512_permutex2var_epi32(t, IDX_U0, x);
+  r[1] = _mm512_permutex2var_epi32(y, IDX_U0, v);
+  r[2] = _mm512_permutex2var_epi32(t, IDX_U1, x);
+  r[3] = _mm512_permutex2var_epi32(y, IDX_U1, v);
+}
+
+/* Inverse NTT layers on deinterleaved coefficients, output to a */
+AVX512 static inline void invntt_layers(int32_t a[N], __m512i r[16]) {
+  unsigned int i, j;
+  const __m512i iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                         8, 9, 10, 11, 12, 13, 14, 15);
+  __m512i x, y, u, t, z, zq;
+
+  /* layers 8 to 5 on pairs of registers holding even and odd
+   * coefficients */
+  for(i = 0; i < 8; ++i) {
+    x = r[2*i];
+    y = r[2*i+1];
+    gs(&x, &y, _mm512_loadu_si512(&qdata512.coeffs[_ZETAS512_INV + 16*i]),
+       _mm512_loadu_si512(&qdata512.coeffs[_ZETAS512_INV_QINV + 16*i]));
+
+    t = _mm512_mask_blend_epi32(0xAAAA, x, _mm512_slli_epi64(y, 32));
+    y = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(x, 32), y);
+    gs(&t, &y, ZETAS(_ZETAS512_INV + 128 + 8*i, 1),
+       ZETAS(_ZETAS512_INV_QINV + 128 + 8*i, 1));
+
+    x = _mm512_unpacklo_epi64(t, y);
+    y = _mm512_unpackhi_epi64(t, y);
+    gs(&x, &y, ZETAS(_ZETAS512_INV + 192 + 4*i, 2),
+       ZETAS(_ZETAS512_INV_QINV + 192 + 4*i, 2));
+
+    t = _mm512_permutex2var_epi64(x, IDX_128, y);
+    y = _mm512_permutex2var_epi64(x, IDX_128H, y);
+    gs(&t, &y, ZETAS(_ZETAS512_INV + 224 + 2*i, 3),
+       ZETAS(_ZETAS512_INV_QINV + 224 + 2*i, 3));
+
+    r[2*i] = _mm512_shuffle_i64x2(t, y, 0x44);
+    r[2*i+1] = _mm512_shuffle_i64x2(t, y, 0xEE);
+  }
+
+  /* layers 4 to 1 work on whole registers */
+  for(i = 0; i < 8; ++i) {
+    z = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_INV + 240 + i]);
+    zq = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_INV_QINV + 240 + i]);
+    gs(&r[2*i], &r[2*i+1], z, zq);
+  }
+
+  for(i = 0; i < 4; ++i) {
+    z = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_INV + 248 + i]);
+    zq = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_INV_QINV + 248 + i]);
+    for(j = 0; j < 2; ++j)
+      gs(&r[4*i+j], &r[4*i+j+2], z, zq);
+  }
+
+  for(i = 0; i < 2; ++i) {
+    z = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_INV + 252 + i]);
+    zq = _mm512_set1_epi32(qdata512.coeffs[_ZETAS512_INV_QINV + 252 + i]);
+    for(j = 0; j < 4; ++j)
+      gs(&r[8*i+j], &r[8*i+j+4], z, zq);
+  }
+
+  /* last layer merged with the multiplication by mont^2/256 */
+  for(i = 0; i < 8; ++i) {
+    t = _mm512_add_epi32(r[i], r[i+8]);
+    u = _mm512_sub_epi32(r[i], r[i+8]);
+    t = fqmul(t, _mm512_set1_epi32(qdata512.coeffs[_DIV512 + 1]),
+              _mm512_set1_epi32(qdata512.coeffs[_DIV512]));
+    u = fqmul(u, _mm512_set1_epi32(qdata512.coeffs[_DIV512 + 3]),
+              _mm512_set1_epi32(qdata512.coeffs[_DIV512 + 2]));
+    _mm512_storeu_si512(&a[16*i], t);
+    _mm512_storeu_si512(&a[16*i+128], u);
+  }
+}
+
+/*************************************************
+* Name:        invntt_avx512
+*
+* Description: Inverse NTT and multiplication by Montgomery factor 2^32.
+*              In-place. Input coefficients are in the order of ntt_avx and
+*              need to be less than Q in absolute value. Output coefficients
+*              are bounded by Q in absolute value.
+*
+* Arguments:   - int32_t a[N]: input/output coefficient array
+**************************************************/
+AVX512 void invntt_avx512(int32_t a[N]) {
+  unsigned int i;
+  __m512i r[16];
+
+  for(i = 0; i < 4; ++i)
+    deinterleave(&r[4*i], _mm512_loadu_si512(&a[64*i]),
+                 _mm512_loadu_si512(&a[64*i+16]),
+                 _mm512_loadu_si512(&a[64*i+32]),
+                 _mm512_loadu_si512(&a[64*i+48]));
+  invntt_layers(a, r);
+}
+
+/*************************************************
+* Name:        pointwise_avx512
+*
+* Description: Pointwise multiplication of polynomials in NTT domain
+*              representation and multiplication of resulting polynomial
+*              by 2^{-32}.
+*
+* Arguments:   - int32_t c[N]: output coefficient array
+*              - const int32_t a[N]: first input coefficient array
+*              - const int32_t b[N]: second input coefficient array
+**************************************************/
+AVX512 void pointwise_avx512(int32_t c[N], const int32_t a[N], const int32_t b[N]) {
+  unsigned int i;
+  __m512i x, y, e, o;
+
+  for(i = 0; i < N/16; ++i) {
+    x = _mm512_loadu_si512(&a[16*i]);
+    y = _mm512_loadu_si512(&b[16*i]);
+    e = _mm512_mul_epi32(x, y);
+    o = _mm512_mul_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32));
+    _mm512_storeu_si512(&c[16*i], montred(e, o));
+  }
+}
+
+/* Sum of the products of the 16 coefficients at offset off in the L
+ * polynomials of a and b, minus the product of d and e if d is not NULL,
+ * multiplied by 2^{-32}. The sum is kept in 64-bit lanes and reduced
+ * once. */
+AVX512 static inline __m512i acc16(const int32_t *a, const int32_t *b,
+                                   const int32_t *d, const int32_t *e,
+                                   unsigned int off) {
+  unsigned int j;
+  __m512i x, y, se, so;
+
+  se = so = _mm512_setzero_si512();
+  for(j = 0; j < L; ++j) {
+    x = _mm512_loadu_si512(&a[j*N+off]);
+    y = _mm512_loadu_si512(&b[j*N+off]);
+    se = _mm512_add_epi64(se, _mm512_mul_epi32(x, y));
+    so = _mm512_add_epi64(so, _mm512_mul_epi32(_mm512_srli_epi64(x, 32),
+                                               _mm512_srli_epi64(y, 32)));
+  }
+  if(d) {
+    x = _mm512_loadu_si512(&d[off]);
+    y = _mm512_loadu_si512(&e[off]);
+    se = _mm512_sub_epi64(se, _mm512_mul_epi32(x, y));
+    so = _mm512_sub_epi64(so, _mm512_mul_epi32(_mm512_srli_epi64(x, 32),
+                                               _mm512_srli_epi64(y, 32)));
+  }
+  return montred(se, so);
+}
+
+/*************************************************
+* Name:        pointwise_acc_avx512
+*
+* Description: Pointwise multiply vectors of L polynomials in NTT domain
+*              representation, add the products and multiply the sum by
+*              2^{-32}.
+*
+* Arguments:   - int32_t c[N]: output coefficient array
+*              - const int32_t a[L*N]: first input vector
+*              - const int32_t b[L*N]: second input vector
+**************************************************/
+AVX512 void pointwise_acc_avx512(int32_t c[N], const int32_t a[L*N], const int32_t b[L*N]) {
+  unsigned int i;
+
+  for(i = 0; i < N/16; ++i)
+    _mm512_storeu_si512(&c[16*i], acc16(a, b, NULL, NULL, 16*i));
+}
+
+/*************************************************
+* Name:        pointwise_acc_invntt_avx512
+*
+* Description: Computes the inner product of two vectors of L polynomials
+*              in NTT domain representation like pointwise_acc_avx512,
+*              optionally subtracts the product of the polynomials d and e,
+*              and applies invntt_avx512 to the result. The sum goes
+*              directly into the registers of the inverse NTT and is only
+*              stored once.
+*
+* Arguments:   - int32_t c[N]: output coefficient array
+*              - const int32_t a[L*N]: first input vector
+*              - const int32_t b[L*N]: second input vector
+*              - const int32_t d[N]: first factor of the subtracted product,
+*                                    or NULL
+*              - const int32_t e[N]: second factor of the subtracted product
+**************************************************/
+AVX512 void pointwise_acc_invntt_avx512(int32_t c[N], const int32_t a[L*N], const int32_t b[L*N],
+                                        const int32_t d[N], const int32_t e[N]) {
+  unsigned int i;
+  __m512i r[16];
+
+  for(i = 0; i < 4; ++i)
+    deinterleave(&r[4*i], acc16(a, b, d, e, 64*i), acc16(a, b, d, e, 64*i+16),
+                 acc16(a, b, d, e, 64*i+32), acc16(a, b, d, e, 64*i+48));
+  invntt_layers(c, r);
+}
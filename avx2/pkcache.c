@@ -0,0 +1 @@
+../ref/pkcache.c
\ No newline at end of file
@@ -0,0 +1 @@
+../ref/pkcache.h
\ No newline at end of file
@@ -10,17 +10,8 @@
 #include "consts.h"
 #include "symmetric.h"
 #include "fips202x4.h"
-
-#ifdef DBENCH
-#include "test/cpucycles.h"
-extern const uint64_t timing_overhead;
-extern uint64_t *tred, *tadd, *tmul, *tround, *tsample, *tpack;
-#define DBENCH_START() uint64_t time = cpucycles()
-#define DBENCH_STOP(t) t += cpucycles() - time - timing_overhead
-#else
-#define DBENCH_START()
-#define DBENCH_STOP(t)
-#endif
+#include "fips202x8.h"
+#include "dbench.h"
 
 #define _mm256_blendv_epi32(a,b,mask) \
   _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(a), \
@@ -163,9 +154,12 @@ void poly_shiftl(poly *a) {
 void poly_ntt(poly *a) {
   DBENCH_START();
 
-  ntt_avx(a->vec, qdata.vec);
+  if(fips202x8_available())
+    ntt_avx512(a->coeffs);
+  else
+    ntt_avx(a->vec, qdata.vec);
 
-  DBENCH_STOP(*tmul);
+  DBENCH_STOP(*tntt);
 }
 
 /*************************************************
@@ -180,9 +174,12 @@ void poly_ntt(poly *a) {
 void poly_invntt_tomont(poly *a) {
   DBENCH_START();
 
-  invntt_avx(a->vec, qdata.vec);
+  if(fips202x8_available())
+    invntt_avx512(a->coeffs);
+  else
+    invntt_avx(a->vec, qdata.vec);
 
-  DBENCH_STOP(*tmul);
+  DBENCH_STOP(*tinvntt);
 }
 
 void poly_nttunpack(poly *a) {
@@ -190,7 +187,7 @@ void poly_nttunpack(poly *a) {
 
   nttunpack_avx(a->vec);
 
-  DBENCH_STOP(*tmul);
+  DBENCH_STOP(*tntt);
 }
 
 /*************************************************
@@ -207,7 +204,10 @@ void poly_nttunpack(poly *a) {
 void poly_pointwise_montgomery(poly *c, const poly *a, const poly *b) {
   DBENCH_START();
 
-  pointwise_avx(c->vec, a->vec, b->vec, qdata.vec);
+  if(fips202x8_available())
+    pointwise_avx512(c->coeffs, a->coeffs, b->coeffs);
+  else
+    pointwise_avx(c->vec, a->vec, b->vec, qdata.vec);
 
   DBENCH_STOP(*tmul);
 }
@@ -412,17 +412,44 @@ void poly_uniform_4x(poly *a0,
                      uint16_t nonce1,
                      uint16_t nonce2,
                      uint16_t nonce3)
+{
+  poly_uniform_4x_seeds(a0, a1, a2, a3, seed, seed, seed, seed, nonce0, nonce1, nonce2, nonce3);
+}
+
+/*************************************************
+* Name:        poly_uniform_4x_seeds
+*
+* Description: Sample four polynomials with uniformly random coefficients
+*              in [0,Q-1], each from its own seed and nonce, using the
+*              4-way SHAKE128 implementation
+*
+* Arguments:   - poly *a0, *a1, *a2, *a3: pointers to output polynomials
+*              - const uint8_t seed0[], ...: byte arrays with seeds of length SEEDBYTES
+*              - uint16_t nonce0, ...: 2-byte nonces
+**************************************************/
+void poly_uniform_4x_seeds(poly *a0,
+                           poly *a1,
+                           poly *a2,
+                           poly *a3,
+                           const uint8_t seed0[SEEDBYTES],
+                           const uint8_t seed1[SEEDBYTES],
+                           const uint8_t seed2[SEEDBYTES],
+                           const uint8_t seed3[SEEDBYTES],
+                           uint16_t nonce0,
+                           uint16_t nonce1,
+                           uint16_t nonce2,
+                           uint16_t nonce3)
 {
   unsigned int ctr0, ctr1, ctr2, ctr3;
   ALIGNED_UINT8(REJ_UNIFORM_BUFLEN+8) buf[4];
+  uint8_t *out[4] = {buf[0].coeffs, buf[1].coeffs, buf[2].coeffs, buf[3].coeffs};
+  size_t len[4];
   keccakx4_state state;
-  __m256i f;
 
-  f = _mm256_loadu_si256((__m256i *)seed);
-  _mm256_store_si256(buf[0].vec,f);
-  _mm256_store_si256(buf[1].vec,f);
-  _mm256_store_si256(buf[2].vec,f);
-  _mm256_store_si256(buf[3].vec,f);
+  _mm256_store_si256(buf[0].vec,_mm256_loadu_si256((__m256i *)seed0));
+  _mm256_store_si256(buf[1].vec,_mm256_loadu_si256((__m256i *)seed1));
+  _mm256_store_si256(buf[2].vec,_mm256_loadu_si256((__m256i *)seed2));
+  _mm256_store_si256(buf[3].vec,_mm256_loadu_si256((__m256i *)seed3));
 
   buf[0].coeffs[SEEDBYTES+0] = nonce0;
   buf[0].coeffs[SEEDBYTES+1] = nonce0 >> 8;
@@ -441,13 +468,67 @@ void poly_uniform_4x(poly *a0,
   ctr2 = rej_uniform_avx(a2->coeffs, buf[2].coeffs);
   ctr3 = rej_uniform_avx(a3->coeffs, buf[3].coeffs);
 
+  /* Squeeze 3 bytes per missing coefficient for the unfinished lanes only;
+   * leftover output stays in the state for the next round */
   while(ctr0 < N || ctr1 < N || ctr2 < N || ctr3 < N) {
-    shake128x4_squeezeblocks(buf[0].coeffs, buf[1].coeffs, buf[2].coeffs, buf[3].coeffs, 1, &state);
+    len[0] = 3*(N - ctr0);
+    len[1] = 3*(N - ctr1);
+    len[2] = 3*(N - ctr2);
+    len[3] = 3*(N - ctr3);
+    shake128x4_squeeze(out, len, &state);
+
+    ctr0 += rej_uniform(a0->coeffs + ctr0, N - ctr0, buf[0].coeffs, len[0]);
+    ctr1 += rej_uniform(a1->coeffs + ctr1, N - ctr1, buf[1].coeffs, len[1]);
+    ctr2 += rej_uniform(a2->coeffs + ctr2, N - ctr2, buf[2].coeffs, len[2]);
+    ctr3 += rej_uniform(a3->coeffs + ctr3, N - ctr3, buf[3].coeffs, len[3]);
+  }
+}
+
+/*************************************************
+* Name:        poly_uniform_8x
+*
+* Description: Sample eight polynomials with uniformly random coefficients
+*              in [0,Q-1] using the 8-way SHAKE128 implementation. Must
+*              only be called if fips202x8_available() returns 1.
+*
+* Arguments:   - poly *a[8]: pointers to output polynomials
+*              - const uint8_t seed[]: byte array with seed of length SEEDBYTES
+*              - const uint16_t nonce[8]: 2-byte nonces
+**************************************************/
+void poly_uniform_8x(poly *a[8],
+                     const uint8_t seed[SEEDBYTES],
+                     const uint16_t nonce[8])
+{
+  unsigned int k, ctr[8];
+  ALIGNED_UINT8(REJ_UNIFORM_BUFLEN+8) buf[8];
+  const uint8_t *in[8];
+  uint8_t *out[8];
+  keccakx8_state state;
+
+  for(k = 0; k < 8; ++k) {
+    _mm256_store_si256(buf[k].vec,_mm256_loadu_si256((__m256i *)seed));
+    buf[k].coeffs[SEEDBYTES+0] = nonce[k];
+    buf[k].coeffs[SEEDBYTES+1] = nonce[k] >> 8;
+    in[k] = out[k] = buf[k].coeffs;
+  }
+
+  shake128x8_absorb_once(&state, in, SEEDBYTES + 2);
+  shake128x8_squeezeblocks(out, REJ_UNIFORM_NBLOCKS, &state);
+
+  for(k = 0; k < 8; ++k)
+    ctr[k] = rej_uniform_avx(a[k]->coeffs, buf[k].coeffs);
+
+  /* length of buf is always divisible by 3; hence, no bytes left */
+  for(;;) {
+    for(k = 0; k < 8; ++k)
+      if(ctr[k] < N)
+        break;
+    if(k == 8)
+      break;
 
-    ctr0 += rej_uniform(a0->coeffs + ctr0, N - ctr0, buf[0].coeffs, SHAKE128_RATE);
-    ctr1 += rej_uniform(a1->coeffs + ctr1, N - ctr1, buf[1].coeffs, SHAKE128_RATE);
-    ctr2 += rej_uniform(a2->coeffs + ctr2, N - ctr2, buf[2].coeffs, SHAKE128_RATE);
-    ctr3 += rej_uniform(a3->coeffs + ctr3, N - ctr3, buf[3].coeffs, SHAKE128_RATE);
+    shake128x8_squeezeblocks(out, 1, &state);
+    for(k = 0; k < 8; ++k)
+      ctr[k] += rej_uniform(a[k]->coeffs + ctr[k], N - ctr[k], buf[k].coeffs, SHAKE128_RATE);
   }
 }
 
@@ -541,23 +622,46 @@ void poly_uniform_eta_4x(poly *a0,
                          uint16_t nonce1,
                          uint16_t nonce2,
                          uint16_t nonce3)
+{
+  poly_uniform_eta_4x_seeds(a0, a1, a2, a3, seed, seed, seed, seed, nonce0, nonce1, nonce2, nonce3);
+}
+
+/*************************************************
+* Name:        poly_uniform_eta_4x_seeds
+*
+* Description: Sample four polynomials with uniformly random coefficients
+*              in [-ETA,ETA], each from its own seed and nonce, using the
+*              4-way SHAKE256 implementation
+*
+* Arguments:   - poly *a0, *a1, *a2, *a3: pointers to output polynomials
+*              - const uint8_t seed0[], ...: byte arrays with seeds of length CRHBYTES
+*              - uint16_t nonce0, ...: 2-byte nonces
+**************************************************/
+void poly_uniform_eta_4x_seeds(poly *a0,
+                               poly *a1,
+                               poly *a2,
+                               poly *a3,
+                               const uint8_t seed0[CRHBYTES],
+                               const uint8_t seed1[CRHBYTES],
+                               const uint8_t seed2[CRHBYTES],
+                               const uint8_t seed3[CRHBYTES],
+                               uint16_t nonce0,
+                               uint16_t nonce1,
+                               uint16_t nonce2,
+                               uint16_t nonce3)
 {
   unsigned int ctr0, ctr1, ctr2, ctr3;
   ALIGNED_UINT8(REJ_UNIFORM_ETA_BUFLEN) buf[4];
-
-  __m256i f;
   keccakx4_state state;
 
-  f = _mm256_loadu_si256((__m256i *)&seed[0]);
-  _mm256_store_si256(&buf[0].vec[0],f);
-  _mm256_store_si256(&buf[1].vec[0],f);
-  _mm256_store_si256(&buf[2].vec[0],f);
-  _mm256_store_si256(&buf[3].vec[0],f);
-  f = _mm256_loadu_si256((__m256i *)&seed[32]);
-  _mm256_store_si256(&buf[0].vec[1],f);
-  _mm256_store_si256(&buf[1].vec[1],f);
-  _mm256_store_si256(&buf[2].vec[1],f);
-  _mm256_store_si256(&buf[3].vec[1],f);
+  _mm256_store_si256(&buf[0].vec[0],_mm256_loadu_si256((__m256i *)&seed0[0]));
+  _mm256_store_si256(&buf[0].vec[1],_mm256_loadu_si256((__m256i *)&seed0[32]));
+  _mm256_store_si256(&buf[1].vec[0],_mm256_loadu_si256((__m256i *)&seed1[0]));
+  _mm256_store_si256(&buf[1].vec[1],_mm256_loadu_si256((__m256i *)&seed1[32]));
+  _mm256_store_si256(&buf[2].vec[0],_mm256_loadu_si256((__m256i *)&seed2[0]));
+  _mm256_store_si256(&buf[2].vec[1],_mm256_loadu_si256((__m256i *)&seed2[32]));
+  _mm256_store_si256(&buf[3].vec[0],_mm256_loadu_si256((__m256i *)&seed3[0]));
+  _mm256_store_si256(&buf[3].vec[1],_mm256_loadu_si256((__m256i *)&seed3[32]));
 
   buf[0].coeffs[64] = nonce0;
   buf[0].coeffs[65] = nonce0 >> 8;
@@ -622,21 +726,45 @@ void poly_uniform_gamma1_4x(poly *a0,
                             uint16_t nonce1,
                             uint16_t nonce2,
                             uint16_t nonce3)
+{
+  poly_uniform_gamma1_4x_seeds(a0, a1, a2, a3, seed, seed, seed, seed, nonce0, nonce1, nonce2, nonce3);
+}
+
+/*************************************************
+* Name:        poly_uniform_gamma1_4x_seeds
+*
+* Description: Sample four polynomials with uniformly random coefficients
+*              in [-(GAMMA1 - 1), GAMMA1], each from its own seed and
+*              nonce, using the 4-way SHAKE256 implementation
+*
+* Arguments:   - poly *a0, *a1, *a2, *a3: pointers to output polynomials
+*              - const uint8_t seed0[], ...: byte arrays with seeds of length CRHBYTES
+*              - uint16_t nonce0, ...: 2-byte nonces
+**************************************************/
+void poly_uniform_gamma1_4x_seeds(poly *a0,
+                                  poly *a1,
+                                  poly *a2,
+                                  poly *a3,
+                                  const uint8_t seed0[CRHBYTES],
+                                  const uint8_t seed1[CRHBYTES],
+                                  const uint8_t seed2[CRHBYTES],
+                                  const uint8_t seed3[CRHBYTES],
+                                  uint16_t nonce0,
+                                  uint16_t nonce1,
+                                  uint16_t nonce2,
+                                  uint16_t nonce3)
 {
   ALIGNED_UINT8(POLY_UNIFORM_GAMMA1_NBLOCKS*STREAM256_BLOCKBYTES+14) buf[4];
   keccakx4_state state;
-  __m256i f;
 
-  f = _mm256_loadu_si256((__m256i *)&seed[0]);
-  _mm256_store_si256(&buf[0].vec[0],f);
-  _mm256_store_si256(&buf[1].vec[0],f);
-  _mm256_store_si256(&buf[2].vec[0],f);
-  _mm256_store_si256(&buf[3].vec[0],f);
-  f = _mm256_loadu_si256((__m256i *)&seed[32]);
-  _mm256_store_si256(&buf[0].vec[1],f);
-  _mm256_store_si256(&buf[1].vec[1],f);
-  _mm256_store_si256(&buf[2].vec[1],f);
-  _mm256_store_si256(&buf[3].vec[1],f);
+  _mm256_store_si256(&buf[0].vec[0],_mm256_loadu_si256((__m256i *)&seed0[0]));
+  _mm256_store_si256(&buf[0].vec[1],_mm256_loadu_si256((__m256i *)&seed0[32]));
+  _mm256_store_si256(&buf[1].vec[0],_mm256_loadu_si256((__m256i *)&seed1[0]));
+  _mm256_store_si256(&buf[1].vec[1],_mm256_loadu_si256((__m256i *)&seed1[32]));
+  _mm256_store_si256(&buf[2].vec[0],_mm256_loadu_si256((__m256i *)&seed2[0]));
+  _mm256_store_si256(&buf[2].vec[1],_mm256_loadu_si256((__m256i *)&seed2[32]));
+  _mm256_store_si256(&buf[3].vec[0],_mm256_loadu_si256((__m256i *)&seed3[0]));
+  _mm256_store_si256(&buf[3].vec[1],_mm256_loadu_si256((__m256i *)&seed3[32]));
 
   buf[0].coeffs[64] = nonce0;
   buf[0].coeffs[65] = nonce0 >> 8;
@@ -656,6 +784,43 @@ void poly_uniform_gamma1_4x(poly *a0,
   polyz_unpack(a3, buf[3].coeffs);
 }
 
+/*************************************************
+* Name:        poly_uniform_gamma1_8x
+*
+* Description: Sample eight polynomials with uniformly random coefficients
+*              in [-(GAMMA1 - 1), GAMMA1] using the 8-way SHAKE256
+*              implementation. Must only be called if fips202x8_available()
+*              returns 1.
+*
+* Arguments:   - poly *a[8]: pointers to output polynomials
+*              - const uint8_t seed[]: byte array with seed of length CRHBYTES
+*              - const uint16_t nonce[8]: 2-byte nonces
+**************************************************/
+void poly_uniform_gamma1_8x(poly *a[8],
+                            const uint8_t seed[CRHBYTES],
+                            const uint16_t nonce[8])
+{
+  unsigned int k;
+  ALIGNED_UINT8(POLY_UNIFORM_GAMMA1_NBLOCKS*STREAM256_BLOCKBYTES+14) buf[8];
+  const uint8_t *in[8];
+  uint8_t *out[8];
+  keccakx8_state state;
+
+  for(k = 0; k < 8; ++k) {
+    _mm256_store_si256(&buf[k].vec[0],_mm256_loadu_si256((__m256i *)&seed[0]));
+    _mm256_store_si256(&buf[k].vec[1],_mm256_loadu_si256((__m256i *)&seed[32]));
+    buf[k].coeffs[64] = nonce[k];
+    buf[k].coeffs[65] = nonce[k] >> 8;
+    in[k] = out[k] = buf[k].coeffs;
+  }
+
+  shake256x8_absorb_once(&state, in, 66);
+  shake256x8_squeezeblocks(out, POLY_UNIFORM_GAMMA1_NBLOCKS, &state);
+
+  for(k = 0; k < 8; ++k)
+    polyz_unpack(a[k], buf[k].coeffs);
+}
+
 /*************************************************
 * Name:        challenge
 *
@@ -697,6 +862,188 @@ void poly_challenge(poly * restrict c, const uint8_t seed[CTILDEBYTES]) {
   }
 }
 
+/*************************************************
+* Name:        challenge_4x
+*
+* Description: Samples four challenge polynomials from four seeds using
+*              the 4-way SHAKE256 implementation. Each lane consumes its
+*              own output stream exactly like poly_challenge.
+*
+* Arguments:   - poly *c0-c3: pointers to output polynomials
+*              - const uint8_t seed0-seed3[]: byte arrays containing seeds of
+*                                             length CTILDEBYTES
+**************************************************/
+void poly_challenge_4x(poly *c0,
+                       poly *c1,
+                       poly *c2,
+                       poly *c3,
+                       const uint8_t seed0[CTILDEBYTES],
+                       const uint8_t seed1[CTILDEBYTES],
+                       const uint8_t seed2[CTILDEBYTES],
+                       const uint8_t seed3[CTILDEBYTES])
+{
+  unsigned int i[4], k, b, pos[4], done;
+  uint64_t signs[4];
+  ALIGNED_UINT8(SHAKE256_RATE) buf[4];
+  poly *c[4] = {c0, c1, c2, c3};
+  keccakx4_state state;
+
+  shake256x4_absorb_once(&state, seed0, seed1, seed2, seed3, CTILDEBYTES);
+  shake256x4_squeezeblocks(buf[0].coeffs, buf[1].coeffs, buf[2].coeffs, buf[3].coeffs, 1, &state);
+
+  for(k = 0; k < 4; ++k) {
+    memcpy(&signs[k], buf[k].coeffs, 8);
+    pos[k] = 8;
+    i[k] = N-TAU;
+    memset(c[k]->vec, 0, sizeof(poly));
+  }
+
+  for(;;) {
+    /* Run every lane until it is finished or out of bytes */
+    done = 0;
+    for(k = 0; k < 4; ++k) {
+      while(i[k] < N && pos[k] < SHAKE256_RATE) {
+        b = buf[k].coeffs[pos[k]++];
+        if(b > i[k])
+          continue;
+
+        c[k]->coeffs[i[k]] = c[k]->coeffs[b];
+        c[k]->coeffs[b] = 1 - 2*(signs[k] & 1);
+        signs[k] >>= 1;
+        i[k]++;
+      }
+      done += (i[k] == N);
+    }
+
+    if(done == 4)
+      break;
+
+    shake256x4_squeezeblocks(buf[0].coeffs, buf[1].coeffs, buf[2].coeffs, buf[3].coeffs, 1, &state);
+    for(k = 0; k < 4; ++k)
+      pos[k] = 0;
+  }
+}
+
+/*************************************************
+* Name:        poly_challenge_sparse
+*
+* Description: Extract positions and signs of the TAU nonzero coefficients
+*              of challenge polynomial. The challenge is public, so the
+*              branches do not leak secret information.
+*
+* Arguments:   - sparse_poly *c: pointer to output sparse polynomial
+*              - const poly *cp: pointer to challenge polynomial
+**************************************************/
+void poly_challenge_sparse(sparse_poly *c, const poly *cp) {
+  unsigned int i, k;
+
+  k = 0;
+  for(i = 0; i < N; ++i) {
+    if(cp->coeffs[i]) {
+      c->pos[k] = i;
+      c->neg[k] = cp->coeffs[i] < 0;
+      ++k;
+    }
+  }
+}
+
+/*************************************************
+* Name:        poly_sparse_mul_eta
+*
+* Description: Multiplication of polynomial with coefficients in [-ETA,ETA]
+*              by sparse polynomial with coefficients in {-1,0,1}, as sum
+*              of signed negacyclic rotations. The rotations are read at
+*              unaligned offsets from a buffer holding (-a, a, a, -a), so
+*              that every term is a plain addition. They are summed in 8-bit
+*              lanes if TAU*ETA < 2^7 (Dilithium2 and Dilithium5) and in
+*              16-bit lanes otherwise, so that the sums are exact. Output
+*              coefficients are bounded by TAU*ETA in absolute value.
+*
+* Arguments:   - poly *r: pointer to output polynomial
+*              - const sparse_poly *c: pointer to sparse polynomial
+*              - const poly *a: pointer to input polynomial
+**************************************************/
+void poly_sparse_mul_eta(poly *r, const sparse_poly *c, const poly *a) {
+  unsigned int i, j, k;
+  __m256i f0, f1, g, acc[8];
+#if TAU*ETA < 128
+  __m256i f2, f3;
+  const __m256i idx = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  ALIGNED_UINT8(4*N) ext;
+  const uint8_t *p[TAU];
+#else
+  ALIGNED_INT16(4*N) ext;
+  const int16_t *p[TAU];
+#endif
+  DBENCH_START();
+
+#if TAU*ETA < 128
+  for(i = 0; i < N/32; i++) {
+    f0 = _mm256_load_si256(&a->vec[4*i + 0]);
+    f1 = _mm256_load_si256(&a->vec[4*i + 1]);
+    f2 = _mm256_load_si256(&a->vec[4*i + 2]);
+    f3 = _mm256_load_si256(&a->vec[4*i + 3]);
+    f0 = _mm256_packs_epi32(f0, f1);
+    f2 = _mm256_packs_epi32(f2, f3);
+    f0 = _mm256_packs_epi16(f0, f2);
+    f0 = _mm256_permutevar8x32_epi32(f0, idx);
+    g = _mm256_sub_epi8(_mm256_setzero_si256(), f0);
+    _mm256_store_si256(&ext.vec[i], g);
+    _mm256_store_si256(&ext.vec[N/32 + i], f0);
+    _mm256_store_si256(&ext.vec[2*N/32 + i], f0);
+    _mm256_store_si256(&ext.vec[3*N/32 + i], g);
+  }
+
+  for(k = 0; k < TAU; k++)
+    p[k] = &ext.coeffs[2*N*c->neg[k] + N - c->pos[k]];
+
+  for(j = 0; j < 8; j++)
+    acc[j] = _mm256_setzero_si256();
+  for(k = 0; k < TAU; k++)
+    for(j = 0; j < 8; j++)
+      acc[j] = _mm256_add_epi8(acc[j], _mm256_loadu_si256((__m256i *)&p[k][32*j]));
+
+  /* Sign-extend to 32 bits */
+  for(j = 0; j < 8; j++)
+    _mm256_store_si256(&ext.vec[j], acc[j]);
+  for(i = 0; i < N/8; i++)
+    _mm256_store_si256(&r->vec[i], _mm256_cvtepi8_epi32(_mm_loadl_epi64((__m128i *)&ext.coeffs[8*i])));
+#else
+  for(i = 0; i < N/16; i++) {
+    f0 = _mm256_load_si256(&a->vec[2*i + 0]);
+    f1 = _mm256_load_si256(&a->vec[2*i + 1]);
+    f0 = _mm256_packs_epi32(f0, f1);
+    f0 = _mm256_permute4x64_epi64(f0, 0xD8);
+    g = _mm256_sub_epi16(_mm256_setzero_si256(), f0);
+    _mm256_store_si256(&ext.vec[i], g);
+    _mm256_store_si256(&ext.vec[N/16 + i], f0);
+    _mm256_store_si256(&ext.vec[2*N/16 + i], f0);
+    _mm256_store_si256(&ext.vec[3*N/16 + i], g);
+  }
+
+  for(k = 0; k < TAU; k++)
+    p[k] = &ext.coeffs[2*N*c->neg[k] + N - c->pos[k]];
+
+  for(i = 0; i < N; i += 128) {
+    for(j = 0; j < 8; j++)
+      acc[j] = _mm256_setzero_si256();
+    for(k = 0; k < TAU; k++)
+      for(j = 0; j < 8; j++)
+        acc[j] = _mm256_add_epi16(acc[j], _mm256_loadu_si256((__m256i *)&p[k][i + 16*j]));
+
+    /* Sign-extend to 32 bits */
+    for(j = 0; j < 8; j++) {
+      f0 = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(acc[j]));
+      f1 = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(acc[j], 1));
+      _mm256_store_si256(&r->vec[i/8 + 2*j + 0], f0);
+      _mm256_store_si256(&r->vec[i/8 + 2*j + 1], f1);
+    }
+  }
+#endif
+
+  DBENCH_STOP(*tmul);
+}
+
 /*************************************************
 * Name:        polyeta_pack
 *
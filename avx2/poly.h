@@ -8,6 +8,13 @@
 
 typedef ALIGNED_INT32(N) poly;
 
+/* Sparse polynomial given by positions and signs of its TAU nonzero
+ * coefficients, all of which are 1 or -1 */
+typedef struct {
+  uint8_t pos[TAU];
+  uint8_t neg[TAU];
+} sparse_poly;
+
 #define poly_reduce DILITHIUM_NAMESPACE(poly_reduce)
 void poly_reduce(poly *a);
 #define poly_caddq DILITHIUM_NAMESPACE(poly_caddq)
@@ -54,6 +61,19 @@ void poly_uniform_gamma1_preinit(poly *a, stream256_state *state);
 void poly_uniform_gamma1(poly *a, const uint8_t seed[CRHBYTES], uint16_t nonce);
 #define poly_challenge DILITHIUM_NAMESPACE(poly_challenge)
 void poly_challenge(poly *c, const uint8_t seed[CTILDEBYTES]);
+#define poly_challenge_4x DILITHIUM_NAMESPACE(poly_challenge_4x)
+void poly_challenge_4x(poly *c0,
+                       poly *c1,
+                       poly *c2,
+                       poly *c3,
+                       const uint8_t seed0[CTILDEBYTES],
+                       const uint8_t seed1[CTILDEBYTES],
+                       const uint8_t seed2[CTILDEBYTES],
+                       const uint8_t seed3[CTILDEBYTES]);
+#define poly_challenge_sparse DILITHIUM_NAMESPACE(poly_challenge_sparse)
+void poly_challenge_sparse(sparse_poly *c, const poly *cp);
+#define poly_sparse_mul_eta DILITHIUM_NAMESPACE(poly_sparse_mul_eta)
+void poly_sparse_mul_eta(poly *r, const sparse_poly *c, const poly *a);
 
 #define poly_uniform_4x DILITHIUM_NAMESPACE(poly_uniform_4x)
 void poly_uniform_4x(poly *a0,
@@ -65,6 +85,19 @@ void poly_uniform_4x(poly *a0,
                      uint16_t nonce1,
                      uint16_t nonce2,
                      uint16_t nonce3);
+#define poly_uniform_4x_seeds DILITHIUM_NAMESPACE(poly_uniform_4x_seeds)
+void poly_uniform_4x_seeds(poly *a0,
+                           poly *a1,
+                           poly *a2,
+                           poly *a3,
+                           const uint8_t seed0[SEEDBYTES],
+                           const uint8_t seed1[SEEDBYTES],
+                           const uint8_t seed2[SEEDBYTES],
+                           const uint8_t seed3[SEEDBYTES],
+                           uint16_t nonce0,
+                           uint16_t nonce1,
+                           uint16_t nonce2,
+                           uint16_t nonce3);
 #define poly_uniform_eta_4x DILITHIUM_NAMESPACE(poly_uniform_eta_4x)
 void poly_uniform_eta_4x(poly *a0,
                          poly *a1,
@@ -75,6 +108,19 @@ void poly_uniform_eta_4x(poly *a0,
                          uint16_t nonce1,
                          uint16_t nonce2,
                          uint16_t nonce3);
+#define poly_uniform_eta_4x_seeds DILITHIUM_NAMESPACE(poly_uniform_eta_4x_seeds)
+void poly_uniform_eta_4x_seeds(poly *a0,
+                               poly *a1,
+                               poly *a2,
+                               poly *a3,
+                               const uint8_t seed0[CRHBYTES],
+                               const uint8_t seed1[CRHBYTES],
+                               const uint8_t seed2[CRHBYTES],
+                               const uint8_t seed3[CRHBYTES],
+                               uint16_t nonce0,
+                               uint16_t nonce1,
+                               uint16_t nonce2,
+                               uint16_t nonce3);
 #define poly_uniform_gamma1_4x DILITHIUM_NAMESPACE(poly_uniform_gamma1_4x)
 void poly_uniform_gamma1_4x(poly *a0,
                             poly *a1,
@@ -85,6 +131,28 @@ void poly_uniform_gamma1_4x(poly *a0,
                             uint16_t nonce1,
                             uint16_t nonce2,
                             uint16_t nonce3);
+#define poly_uniform_gamma1_4x_seeds DILITHIUM_NAMESPACE(poly_uniform_gamma1_4x_seeds)
+void poly_uniform_gamma1_4x_seeds(poly *a0,
+                                  poly *a1,
+                                  poly *a2,
+                                  poly *a3,
+                                  const uint8_t seed0[CRHBYTES],
+                                  const uint8_t seed1[CRHBYTES],
+                                  const uint8_t seed2[CRHBYTES],
+                                  const uint8_t seed3[CRHBYTES],
+                                  uint16_t nonce0,
+                                  uint16_t nonce1,
+                                  uint16_t nonce2,
+                                  uint16_t nonce3);
+
+#define poly_uniform_8x DILITHIUM_NAMESPACE(poly_uniform_8x)
+void poly_uniform_8x(poly *a[8],
+                     const uint8_t seed[SEEDBYTES],
+                     const uint16_t nonce[8]);
+#define poly_uniform_gamma1_8x DILITHIUM_NAMESPACE(poly_uniform_gamma1_8x)
+void poly_uniform_gamma1_8x(poly *a[8],
+                            const uint8_t seed[CRHBYTES],
+                            const uint16_t nonce[8]);
 
 #define polyeta_pack DILITHIUM_NAMESPACE(polyeta_pack)
 void polyeta_pack(uint8_t r[POLYETA_PACKEDBYTES], const poly *a);
@@ -1,9 +1,84 @@
+#include <stddef.h>
 #include <stdint.h>
 #include "params.h"
 #include "polyvec.h"
 #include "poly.h"
 #include "ntt.h"
 #include "consts.h"
+#include "fips202x8.h"
+#include "dbench.h"
+
+/*************************************************
+* Name:        polyvec_matrix_expand_8x
+*
+* Description: Implementation of ExpandA using the 8-way SHAKE128
+*              implementation. Samples the K*L polynomials in row-major
+*              order, eight at a time; missing lanes of the last batch go
+*              to a scratch polynomial.
+*
+* Arguments:   - polyvecl mat[K]: output matrix
+*              - const uint8_t rho[]: byte array containing seed rho
+**************************************************/
+static void polyvec_matrix_expand_8x(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
+  unsigned int i, j, k;
+  poly pad;
+  poly *a[8];
+  uint16_t nonce[8];
+
+  for(i = 0; i < K*L; i += 8) {
+    for(k = 0; k < 8; ++k) {
+      if(i + k < K*L) {
+        a[k] = &mat[(i + k)/L].vec[(i + k)%L];
+        nonce[k] = (((i + k)/L) << 8) + (i + k)%L;
+      }
+      else {
+        a[k] = &pad;
+        nonce[k] = 0;
+      }
+    }
+    poly_uniform_8x(a, rho, nonce);
+  }
+
+  for(i = 0; i < K; ++i)
+    for(j = 0; j < L; ++j)
+      poly_nttunpack(&mat[i].vec[j]);
+}
+
+/*************************************************
+* Name:        polyvec_matrix_expand_rowpair_8x
+*
+* Description: Samples rows i and i+1 of matrix A using the 8-way SHAKE128
+*              implementation, for callers that consume A row by row.
+*              Missing lanes of the last batch go to a scratch polynomial.
+*
+* Arguments:   - polyvecl rows[2]: output rows i and i+1
+*              - const uint8_t rho[]: byte array containing seed rho
+*              - unsigned int i: index of first row; must be even
+**************************************************/
+void polyvec_matrix_expand_rowpair_8x(polyvecl rows[2], const uint8_t rho[SEEDBYTES], unsigned int i) {
+  unsigned int j, k;
+  poly pad;
+  poly *a[8];
+  uint16_t nonce[8];
+
+  for(j = 0; j < 2*L; j += 8) {
+    for(k = 0; k < 8; ++k) {
+      if(j + k < 2*L) {
+        a[k] = &rows[(j + k)/L].vec[(j + k)%L];
+        nonce[k] = ((i + (j + k)/L) << 8) + (j + k)%L;
+      }
+      else {
+        a[k] = &pad;
+        nonce[k] = 0;
+      }
+    }
+    poly_uniform_8x(a, rho, nonce);
+  }
+
+  for(j = 0; j < 2; ++j)
+    for(k = 0; k < L; ++k)
+      poly_nttunpack(&rows[j].vec[k]);
+}
 
 /*************************************************
 * Name:        expand_mat
@@ -15,9 +90,13 @@
 * Arguments:   - polyvecl mat[K]: output matrix
 *              - const uint8_t rho[]: byte array containing seed rho
 **************************************************/
-
 #if K == 4 && L == 4
 void polyvec_matrix_expand(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
+  if(fips202x8_available()) {
+    polyvec_matrix_expand_8x(mat, rho);
+    return;
+  }
+
   polyvec_matrix_expand_row0(&mat[0], NULL, rho);
   polyvec_matrix_expand_row1(&mat[1], NULL, rho);
   polyvec_matrix_expand_row2(&mat[2], NULL, rho);
@@ -59,6 +138,12 @@ void polyvec_matrix_expand_row3(polyvecl *rowa, __attribute__((unused)) polyvecl
 #elif K == 6 && L == 5
 void polyvec_matrix_expand(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
   polyvecl tmp;
+
+  if(fips202x8_available()) {
+    polyvec_matrix_expand_8x(mat, rho);
+    return;
+  }
+
   polyvec_matrix_expand_row0(&mat[0], &mat[1], rho);
   polyvec_matrix_expand_row1(&mat[1], &mat[2], rho);
   polyvec_matrix_expand_row2(&mat[2], &mat[3], rho);
@@ -125,6 +210,11 @@ void polyvec_matrix_expand_row5(polyvecl *rowa, polyvecl *rowb, const uint8_t rh
 
 #elif K == 8 && L == 7
 void polyvec_matrix_expand(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
+  if(fips202x8_available()) {
+    polyvec_matrix_expand_8x(mat, rho);
+    return;
+  }
+
   polyvec_matrix_expand_row0(&mat[0], &mat[1], rho);
   polyvec_matrix_expand_row1(&mat[1], &mat[2], rho);
   polyvec_matrix_expand_row2(&mat[2], &mat[3], rho);
@@ -323,7 +413,74 @@ void polyvecl_pointwise_poly_montgomery(polyvecl *r, const poly *a, const polyve
 *              - const polyvecl *v: pointer to second input vector
 **************************************************/
 void polyvecl_pointwise_acc_montgomery(poly *w, const polyvecl *u, const polyvecl *v) {
-  pointwise_acc_avx(w->vec, u->vec->vec, v->vec->vec, qdata.vec);
+  DBENCH_START();
+
+  if(fips202x8_available())
+    pointwise_acc_avx512(w->coeffs, u->vec->coeffs, v->vec->coeffs);
+  else
+    pointwise_acc_avx(w->vec, u->vec->vec, v->vec->vec, qdata.vec);
+
+  DBENCH_STOP(*tmul);
+}
+
+/*************************************************
+* Name:        polyvecl_pointwise_acc_invntt_tomont
+*
+* Description: Same as polyvecl_pointwise_acc_montgomery followed by
+*              poly_invntt_tomont on the output, but fused into a single
+*              pass with AVX-512.
+*
+* Arguments:   - poly *w: output polynomial in normal domain
+*              - const polyvecl *u: pointer to first input vector
+*              - const polyvecl *v: pointer to second input vector
+**************************************************/
+void polyvecl_pointwise_acc_invntt_tomont(poly *w, const polyvecl *u, const polyvecl *v) {
+  if(fips202x8_available()) {
+    DBENCH_START();
+    pointwise_acc_invntt_avx512(w->coeffs, u->vec->coeffs, v->vec->coeffs, NULL, NULL);
+    DBENCH_STOP(*tinvntt);
+  }
+  else {
+    polyvecl_pointwise_acc_montgomery(w, u, v);
+    poly_invntt_tomont(w);
+  }
+}
+
+/*************************************************
+* Name:        polyvecl_pointwise_acc_sub_invntt_tomont
+*
+* Description: Compute the inverse NTT of the inner product of u and v minus
+*              the product of a and b, as needed for w = Az - ct1*2^d in
+*              verification. With AVX-512 the product of a and b is
+*              subtracted before the single Montgomery reduction of the
+*              sum, which feeds the inverse NTT directly.
+*
+* Arguments:   - poly *w: output polynomial in normal domain
+*              - const polyvecl *u: pointer to first input vector
+*              - const polyvecl *v: pointer to second input vector
+*              - const poly *a: pointer to first factor of subtrahend
+*              - const poly *b: pointer to second factor of subtrahend
+**************************************************/
+void polyvecl_pointwise_acc_sub_invntt_tomont(poly *w,
+                                              const polyvecl *u,
+                                              const polyvecl *v,
+                                              const poly *a,
+                                              const poly *b)
+{
+  poly t;
+
+  if(fips202x8_available()) {
+    DBENCH_START();
+    pointwise_acc_invntt_avx512(w->coeffs, u->vec->coeffs, v->vec->coeffs, a->coeffs, b->coeffs);
+    DBENCH_STOP(*tinvntt);
+  }
+  else {
+    polyvecl_pointwise_acc_montgomery(w, u, v);
+    poly_pointwise_montgomery(&t, a, b);
+    poly_sub(w, w, &t);
+    poly_reduce(w);
+    poly_invntt_tomont(w);
+  }
 }
 
 /*************************************************
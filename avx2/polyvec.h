@@ -33,6 +33,18 @@ void polyvecl_pointwise_poly_montgomery(polyvecl *r, const poly *a, const polyve
 void polyvecl_pointwise_acc_montgomery(poly *w,
                                        const polyvecl *u,
                                        const polyvecl *v);
+#define polyvecl_pointwise_acc_invntt_tomont \
+        DILITHIUM_NAMESPACE(polyvecl_pointwise_acc_invntt_tomont)
+void polyvecl_pointwise_acc_invntt_tomont(poly *w,
+                                          const polyvecl *u,
+                                          const polyvecl *v);
+#define polyvecl_pointwise_acc_sub_invntt_tomont \
+        DILITHIUM_NAMESPACE(polyvecl_pointwise_acc_sub_invntt_tomont)
+void polyvecl_pointwise_acc_sub_invntt_tomont(poly *w,
+                                              const polyvecl *u,
+                                              const polyvecl *v,
+                                              const poly *a,
+                                              const poly *b);
 
 #define polyvecl_chknorm DILITHIUM_NAMESPACE(polyvecl_chknorm)
 int polyvecl_chknorm(const polyvecl *v, int32_t B);
@@ -82,6 +94,9 @@ void polyveck_pack_w1(uint8_t r[K*POLYW1_PACKEDBYTES], const polyveck *w1);
 #define polyvec_matrix_expand DILITHIUM_NAMESPACE(polyvec_matrix_expand)
 void polyvec_matrix_expand(polyvecl mat[K], const uint8_t rho[SEEDBYTES]);
 
+#define polyvec_matrix_expand_rowpair_8x DILITHIUM_NAMESPACE(polyvec_matrix_expand_rowpair_8x)
+void polyvec_matrix_expand_rowpair_8x(polyvecl rows[2], const uint8_t rho[SEEDBYTES], unsigned int i);
+
 #define polyvec_matrix_expand_row0 DILITHIUM_NAMESPACE(polyvec_matrix_expand_row0)
 void polyvec_matrix_expand_row0(polyvecl *rowa, polyvecl *rowb, const uint8_t rho[SEEDBYTES]);
 #define polyvec_matrix_expand_row1 DILITHIUM_NAMESPACE(polyvec_matrix_expand_row1)
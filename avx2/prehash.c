@@ -0,0 +1 @@
+../ref/prehash.c
\ No newline at end of file
@@ -0,0 +1 @@
+../ref/prehash.h
\ No newline at end of file
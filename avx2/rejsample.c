@@ -3,6 +3,7 @@
 #include "params.h"
 #include "rejsample.h"
 #include "symmetric.h"
+#include "dbench.h"
 
 const uint8_t idxlut[256][8] = {
   { 0,  0,  0,  0,  0,  0,  0,  0},
@@ -275,6 +276,8 @@ unsigned int rej_uniform_avx(int32_t * restrict r, const uint8_t buf[REJ_UNIFORM
                                         -1,11,10, 9,-1, 8, 7, 6,
                                         -1, 5, 4, 3,-1, 2, 1, 0);
 
+  DBENCH_START();
+
   ctr = pos = 0;
   while(pos <= REJ_UNIFORM_BUFLEN - 24) {
     d = _mm256_loadu_si256((__m256i *)&buf[pos]);
@@ -305,6 +308,7 @@ unsigned int rej_uniform_avx(int32_t * restrict r, const uint8_t buf[REJ_UNIFORM
       r[ctr++] = t;
   }
 
+  DBENCH_STOP(*tsample);
   return ctr;
 }
 
@@ -320,6 +324,8 @@ unsigned int rej_eta_avx(int32_t * restrict r, const uint8_t buf[REJ_UNIFORM_ETA
   const __m256i v = _mm256_set1_epi32(-6560);
   const __m256i p = _mm256_set1_epi32(5);
 
+  DBENCH_START();
+
   ctr = pos = 0;
   while(ctr <= N - 8 && pos <= REJ_UNIFORM_ETA_BUFLEN - 16) {
     f0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *)&buf[pos]));
@@ -397,6 +403,7 @@ unsigned int rej_eta_avx(int32_t * restrict r, const uint8_t buf[REJ_UNIFORM_ETA
     }
   }
 
+  DBENCH_STOP(*tsample);
   return ctr;
 }
 
@@ -410,6 +417,8 @@ unsigned int rej_eta_avx(int32_t * restrict r, const uint8_t buf[REJ_UNIFORM_ETA
   const __m256i eta = _mm256_set1_epi8(4);
   const __m256i bound = _mm256_set1_epi8(9);
 
+  DBENCH_START();
+
   ctr = pos = 0;
   while(ctr <= N - 8 && pos <= REJ_UNIFORM_ETA_BUFLEN - 16) {
     f0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *)&buf[pos]));
@@ -471,6 +480,7 @@ unsigned int rej_eta_avx(int32_t * restrict r, const uint8_t buf[REJ_UNIFORM_ETA
       r[ctr++] = 4 - t1;
   }
 
+  DBENCH_STOP(*tsample);
   return ctr;
 }
 #endif
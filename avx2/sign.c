@@ -3,14 +3,26 @@
 #include "align.h"
 #include "params.h"
 #include "sign.h"
+#include "pkcache.h"
 #include "packing.h"
 #include "polyvec.h"
 #include "poly.h"
 #include "randombytes.h"
 #include "symmetric.h"
 #include "fips202.h"
+#include "fips202x4.h"
+#include "fips202x8.h"
+#include "dbench.h"
 
 static inline void polyvec_matrix_expand_row(polyvecl **row, polyvecl buf[2], const uint8_t rho[SEEDBYTES], unsigned int i) {
+  /* K is even; the 8-way engine samples rows in pairs */
+  if(fips202x8_available()) {
+    if(!(i & 1))
+      polyvec_matrix_expand_rowpair_8x(buf, rho, i);
+    *row = buf + (i & 1);
+    return;
+  }
+
   switch(i) {
     case 0:
       polyvec_matrix_expand_row0(buf, buf + 1, rho);
@@ -52,18 +64,20 @@ static inline void polyvec_matrix_expand_row(polyvecl **row, polyvecl buf[2], co
 }
 
 /*************************************************
-* Name:        crypto_sign_keypair
+* Name:        crypto_sign_seed_keypair
 *
-* Description: Generates public and private key.
+* Description: Deterministically generates public and private key from seed.
 *
 * Arguments:   - uint8_t *pk: pointer to output public key (allocated
 *                             array of CRYPTO_PUBLICKEYBYTES bytes)
 *              - uint8_t *sk: pointer to output private key (allocated
 *                             array of CRYPTO_SECRETKEYBYTES bytes)
+*              - const uint8_t *seed: pointer to input seed (of length
+*                                     CRYPTO_SEEDKEYBYTES)
 *
 * Returns 0 (success)
 **************************************************/
-int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
+int crypto_sign_seed_keypair(uint8_t *pk, uint8_t *sk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]) {
   unsigned int i;
   uint8_t seedbuf[2*SEEDBYTES + CRHBYTES];
   const uint8_t *rho, *rhoprime, *key;
@@ -72,8 +86,8 @@ int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
   polyveck s2;
   poly t1, t0;
 
-  /* Get randomness for rho, rhoprime and key */
-  randombytes(seedbuf, SEEDBYTES);
+  /* Expand seed to rho, rhoprime and key */
+  memcpy(seedbuf, seed, SEEDBYTES);
   seedbuf[SEEDBYTES+0] = K;
   seedbuf[SEEDBYTES+1] = L;
   shake256(seedbuf, 2*SEEDBYTES + CRHBYTES, seedbuf, SEEDBYTES+2);
@@ -117,8 +131,7 @@ int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
     polyvec_matrix_expand_row(&row, rowbuf, rho, i);
 
     /* Compute inner-product */
-    polyvecl_pointwise_acc_montgomery(&t1, row, &s1);
-    poly_invntt_tomont(&t1);
+    polyvecl_pointwise_acc_invntt_tomont(&t1, row, &s1);
 
     /* Add error polynomial */
     poly_add(&t1, &t1, &s2.vec[i]);
@@ -137,358 +150,1676 @@ int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
 }
 
 /*************************************************
-* Name:        crypto_sign_signature_internal
+* Name:        crypto_sign_keypair
 *
-* Description: Computes signature. Internal API.
+* Description: Generates public and private key.
 *
-* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
-*              - size_t *siglen: pointer to output length of signature
-*              - uint8_t *m: pointer to message to be signed
-*              - size_t mlen: length of message
-*              - uint8_t *pre: pointer to prefix string
-*              - size_t prelen: length of prefix string
-*              - uint8_t *rnd: pointer to random seed
-*              - uint8_t *sk: pointer to bit-packed secret key
+* Arguments:   - uint8_t *pk: pointer to output public key (allocated
+*                             array of CRYPTO_PUBLICKEYBYTES bytes)
+*              - uint8_t *sk: pointer to output private key (allocated
+*                             array of CRYPTO_SECRETKEYBYTES bytes)
 *
 * Returns 0 (success)
 **************************************************/
-int crypto_sign_signature_internal(uint8_t *sig, size_t *siglen, const uint8_t *m, size_t mlen,
-                                   const uint8_t *pre, size_t prelen, const uint8_t rnd[RNDBYTES], const uint8_t *sk)
-{
-  unsigned int i, n, pos;
-  uint8_t seedbuf[2*SEEDBYTES + TRBYTES + 2*CRHBYTES];
-  uint8_t *rho, *tr, *key, *mu, *rhoprime;
-  uint8_t hintbuf[N];
-  uint8_t *hint = sig + CTILDEBYTES + L*POLYZ_PACKEDBYTES;
-  uint64_t nonce = 0;
-  polyvecl mat[K], s1, z;
-  polyveck t0, s2, w1;
-  poly c, tmp;
-  union {
-    polyvecl y;
-    polyveck w0;
-  } tmpv;
-  keccak_state state;
-
-  rho = seedbuf;
-  tr = rho + SEEDBYTES;
-  key = tr + TRBYTES;
-  mu = key + SEEDBYTES;
-  rhoprime = mu + CRHBYTES;
-  unpack_sk(rho, tr, key, &t0, &s1, &s2, sk);
+int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
+  uint8_t seed[CRYPTO_SEEDKEYBYTES];
 
-  /* Compute mu = CRH(tr, pre, msg) */
-  shake256_init(&state);
-  shake256_absorb(&state, tr, TRBYTES);
-  shake256_absorb(&state, pre, prelen);
-  shake256_absorb(&state, m, mlen);
-  shake256_finalize(&state);
-  shake256_squeeze(mu, CRHBYTES, &state);
+  randombytes(seed, CRYPTO_SEEDKEYBYTES);
+  return crypto_sign_seed_keypair(pk, sk, seed);
+}
 
-  /* Compute rhoprime = CRH(key, rnd, mu) */
-  shake256_init(&state);
-  shake256_absorb(&state, key, SEEDBYTES);
-  shake256_absorb(&state, rnd, RNDBYTES);
-  shake256_absorb(&state, mu, CRHBYTES);
-  shake256_finalize(&state);
-  shake256_squeeze(rhoprime, CRHBYTES, &state);
+/*************************************************
+* Name:        crypto_sign_seed_keypair_x4
+*
+* Description: Deterministically generates four key pairs from four seeds.
+*              Equivalent to four calls of crypto_sign_seed_keypair, but
+*              the four lanes of the 4-way Keccak implementation hold the
+*              same step of the four keys, so that seed expansion, sampling
+*              of s1 and s2, ExpandA and the hash of the public key always
+*              run with all lanes filled.
+*
+* Arguments:   - uint8_t *pk[4]: pointers to output public keys (allocated
+*                                arrays of CRYPTO_PUBLICKEYBYTES bytes)
+*              - uint8_t *sk[4]: pointers to output private keys (allocated
+*                                arrays of CRYPTO_SECRETKEYBYTES bytes)
+*              - const uint8_t *seed[4]: pointers to input seeds (of length
+*                                        CRYPTO_SEEDKEYBYTES)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_seed_keypair_x4(uint8_t *pk[4], uint8_t *sk[4], const uint8_t *seed[4]) {
+  unsigned int i, j, k;
+  uint8_t inbuf[4][SEEDBYTES+2];
+  uint8_t seedbuf[4][2*SEEDBYTES + CRHBYTES];
+  const uint8_t *rho[4], *rhoprime[4], *key[4];
+  polyvecl s1[4], row[4];
+  polyveck s2[4];
+  poly t1, t0;
 
-  /* Expand matrix and transform vectors */
-  polyvec_matrix_expand(mat, rho);
-  polyvecl_ntt(&s1);
-  polyveck_ntt(&s2);
-  polyveck_ntt(&t0);
+  /* Expand seeds to rho, rhoprime and key */
+  for(k = 0; k < 4; k++) {
+    memcpy(inbuf[k], seed[k], SEEDBYTES);
+    inbuf[k][SEEDBYTES+0] = K;
+    inbuf[k][SEEDBYTES+1] = L;
+  }
+  shake256x4(seedbuf[0], seedbuf[1], seedbuf[2], seedbuf[3], 2*SEEDBYTES + CRHBYTES,
+             inbuf[0], inbuf[1], inbuf[2], inbuf[3], SEEDBYTES+2);
 
-rej:
-  /* Sample intermediate vector y */
-#if L == 4
-  poly_uniform_gamma1_4x(&z.vec[0], &z.vec[1], &z.vec[2], &z.vec[3],
-                         rhoprime, nonce, nonce + 1, nonce + 2, nonce + 3);
-  nonce += 4;
-#elif L == 5
-  poly_uniform_gamma1_4x(&z.vec[0], &z.vec[1], &z.vec[2], &z.vec[3],
-                         rhoprime, nonce, nonce + 1, nonce + 2, nonce + 3);
-  poly_uniform_gamma1(&z.vec[4], rhoprime, nonce + 4);
-  nonce += 5;
-#elif L == 7
-  poly_uniform_gamma1_4x(&z.vec[0], &z.vec[1], &z.vec[2], &z.vec[3],
-                         rhoprime, nonce, nonce + 1, nonce + 2, nonce + 3);
-  poly_uniform_gamma1_4x(&z.vec[4], &z.vec[5], &z.vec[6], &tmp,
-                         rhoprime, nonce + 4, nonce + 5, nonce + 6, 0);
-  nonce += 7;
-#else
-#error
-#endif
+  for(k = 0; k < 4; k++) {
+    rho[k] = seedbuf[k];
+    rhoprime[k] = rho[k] + SEEDBYTES;
+    key[k] = rhoprime[k] + CRHBYTES;
 
-  /* Matrix-vector product */
-  tmpv.y = z;
-  polyvecl_ntt(&tmpv.y);
-  polyvec_matrix_pointwise_montgomery(&w1, mat, &tmpv.y);
-  polyveck_invntt_tomont(&w1);
+    /* Store rho, key */
+    memcpy(pk[k], rho[k], SEEDBYTES);
+    memcpy(sk[k], rho[k], SEEDBYTES);
+    memcpy(sk[k] + SEEDBYTES, key[k], SEEDBYTES);
+  }
 
-  /* Decompose w and call the random oracle */
-  polyveck_caddq(&w1);
-  polyveck_decompose(&w1, &tmpv.w0, &w1);
-  polyveck_pack_w1(sig, &w1);
+  /* Sample short vectors s1 and s2 */
+  for(j = 0; j < L; j++)
+    poly_uniform_eta_4x_seeds(&s1[0].vec[j], &s1[1].vec[j], &s1[2].vec[j], &s1[3].vec[j],
+                              rhoprime[0], rhoprime[1], rhoprime[2], rhoprime[3], j, j, j, j);
+  for(j = 0; j < K; j++)
+    poly_uniform_eta_4x_seeds(&s2[0].vec[j], &s2[1].vec[j], &s2[2].vec[j], &s2[3].vec[j],
+                              rhoprime[0], rhoprime[1], rhoprime[2], rhoprime[3], L+j, L+j, L+j, L+j);
 
-  shake256_init(&state);
-  shake256_absorb(&state, mu, CRHBYTES);
-  shake256_absorb(&state, sig, K*POLYW1_PACKEDBYTES);
-  shake256_finalize(&state);
-  shake256_squeeze(sig, CTILDEBYTES, &state);
-  poly_challenge(&c, sig);
-  poly_ntt(&c);
+  for(k = 0; k < 4; k++) {
+    /* Pack secret vectors */
+    for(i = 0; i < L; i++)
+      polyeta_pack(sk[k] + 2*SEEDBYTES + TRBYTES + i*POLYETA_PACKEDBYTES, &s1[k].vec[i]);
+    for(i = 0; i < K; i++)
+      polyeta_pack(sk[k] + 2*SEEDBYTES + TRBYTES + (L + i)*POLYETA_PACKEDBYTES, &s2[k].vec[i]);
 
-  /* Compute z, reject if it reveals secret */
-  for(i = 0; i < L; i++) {
-    poly_pointwise_montgomery(&tmp, &c, &s1.vec[i]);
-    poly_invntt_tomont(&tmp);
-    poly_add(&z.vec[i], &z.vec[i], &tmp);
-    poly_reduce(&z.vec[i]);
-    if(poly_chknorm(&z.vec[i], GAMMA1 - BETA))
-      goto rej;
+    /* Transform s1 */
+    polyvecl_ntt(&s1[k]);
   }
 
-  /* Zero hint vector in signature */
-  pos = 0;
-  memset(hint, 0, OMEGA);
-
   for(i = 0; i < K; i++) {
-    /* Check that subtracting cs2 does not change high bits of w and low bits
-     * do not reveal secret information */
-    poly_pointwise_montgomery(&tmp, &c, &s2.vec[i]);
-    poly_invntt_tomont(&tmp);
-    poly_sub(&tmpv.w0.vec[i], &tmpv.w0.vec[i], &tmp);
-    poly_reduce(&tmpv.w0.vec[i]);
-    if(poly_chknorm(&tmpv.w0.vec[i], GAMMA2 - BETA))
-      goto rej;
+    /* Expand i-th matrix row of all four keys */
+    for(j = 0; j < L; j++) {
+      poly_uniform_4x_seeds(&row[0].vec[j], &row[1].vec[j], &row[2].vec[j], &row[3].vec[j],
+                            rho[0], rho[1], rho[2], rho[3],
+                            (i << 8) + j, (i << 8) + j, (i << 8) + j, (i << 8) + j);
+      for(k = 0; k < 4; k++)
+        poly_nttunpack(&row[k].vec[j]);
+    }
 
-    /* Compute hints */
-    poly_pointwise_montgomery(&tmp, &c, &t0.vec[i]);
-    poly_invntt_tomont(&tmp);
-    poly_reduce(&tmp);
-    if(poly_chknorm(&tmp, GAMMA2))
-      goto rej;
+    for(k = 0; k < 4; k++) {
+      /* Compute inner-product */
+      polyvecl_pointwise_acc_invntt_tomont(&t1, &row[k], &s1[k]);
 
-    poly_add(&tmpv.w0.vec[i], &tmpv.w0.vec[i], &tmp);
-    n = poly_make_hint(hintbuf, &tmpv.w0.vec[i], &w1.vec[i]);
-    if(pos + n > OMEGA)
-      goto rej;
+      /* Add error polynomial */
+      poly_add(&t1, &t1, &s2[k].vec[i]);
 
-    /* Store hints in signature */
-    memcpy(&hint[pos], hintbuf, n);
-    hint[OMEGA + i] = pos = pos + n;
+      /* Round t and pack t1, t0 */
+      poly_caddq(&t1);
+      poly_power2round(&t1, &t0, &t1);
+      polyt1_pack(pk[k] + SEEDBYTES + i*POLYT1_PACKEDBYTES, &t1);
+      polyt0_pack(sk[k] + 2*SEEDBYTES + TRBYTES + (L+K)*POLYETA_PACKEDBYTES + i*POLYT0_PACKEDBYTES, &t0);
+    }
   }
 
-  /* Pack z into signature */
-  for(i = 0; i < L; i++)
-    polyz_pack(sig + CTILDEBYTES + i*POLYZ_PACKEDBYTES, &z.vec[i]);
+  /* Compute H(rho, t1) and store in secret keys */
+  shake256x4(sk[0] + 2*SEEDBYTES, sk[1] + 2*SEEDBYTES, sk[2] + 2*SEEDBYTES, sk[3] + 2*SEEDBYTES, TRBYTES,
+             pk[0], pk[1], pk[2], pk[3], CRYPTO_PUBLICKEYBYTES);
 
-  *siglen = CRYPTO_BYTES;
   return 0;
 }
 
 /*************************************************
-* Name:        crypto_sign_signature
+* Name:        crypto_sign_keypair_x4
 *
-* Description: Computes signature.
+* Description: Generates four independent key pairs.
 *
-* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
-*              - size_t *siglen: pointer to output length of signature
-*              - uint8_t *m: pointer to message to be signed
-*              - size_t mlen: length of message
-*              - uint8_t *ctx: pointer to context string
-*              - size_t ctxlen: length of context string
-*              - uint8_t *sk: pointer to bit-packed secret key
+* Arguments:   - uint8_t *pk[4]: pointers to output public keys (allocated
+*                                arrays of CRYPTO_PUBLICKEYBYTES bytes)
+*              - uint8_t *sk[4]: pointers to output private keys (allocated
+*                                arrays of CRYPTO_SECRETKEYBYTES bytes)
 *
-* Returns 0 (success) or -1 (context string too long)
+* Returns 0 (success)
 **************************************************/
-int crypto_sign_signature(uint8_t *sig, size_t *siglen, const uint8_t *m, size_t mlen,
-                          const uint8_t *ctx, size_t ctxlen, const uint8_t *sk)
-{
-  uint8_t pre[257];
-  uint8_t rnd[RNDBYTES];
-
-  if(ctxlen > 255)
-    return -1;
-
-  /* Prepare pre = (0, ctxlen, ctx) */
-  pre[0] = 0;
-  pre[1] = ctxlen;
-  memcpy(&pre[2], ctx, ctxlen);
+int crypto_sign_keypair_x4(uint8_t *pk[4], uint8_t *sk[4]) {
+  unsigned int i;
+  uint8_t seedbuf[4][CRYPTO_SEEDKEYBYTES];
+  const uint8_t *seed[4];
 
-#ifdef DILITHIUM_RANDOMIZED_SIGNING
-  randombytes(rnd, RNDBYTES);
-#else
-  memset(rnd, 0, RNDBYTES);
-#endif
+  randombytes(seedbuf[0], 4*CRYPTO_SEEDKEYBYTES);
+  for(i = 0; i < 4; ++i)
+    seed[i] = seedbuf[i];
 
-  crypto_sign_signature_internal(sig,siglen,m,mlen,pre,2+ctxlen,rnd,sk);
-  return 0;
+  return crypto_sign_seed_keypair_x4(pk, sk, seed);
 }
 
 /*************************************************
-* Name:        crypto_sign
+* Name:        crypto_sign_seed_expand
 *
-* Description: Compute signed message.
+* Description: Expands seed-only secret key to bit-packed secret key.
 *
-* Arguments:   - uint8_t *sm: pointer to output signed message (allocated
-*                             array with CRYPTO_BYTES + mlen bytes),
-*                             can be equal to m
-*              - size_t *smlen: pointer to output length of signed
-*                               message
-*              - const uint8_t *m: pointer to message to be signed
-*              - size_t mlen: length of message
-*              - const uint8_t *ctx: pointer to context string
-*              - size_t ctxlen: length of context string
-*              - const uint8_t *sk: pointer to bit-packed secret key
+* Arguments:   - uint8_t *sk: pointer to output private key (allocated
+*                             array of CRYPTO_SECRETKEYBYTES bytes)
+*              - const uint8_t *seed: pointer to seed-only secret key
+*                                     (of length CRYPTO_SEEDKEYBYTES)
 *
 * Returns 0 (success)
 **************************************************/
-int crypto_sign(uint8_t *sm, size_t *smlen, const uint8_t *m, size_t mlen, const uint8_t *ctx, size_t ctxlen,
-                const uint8_t *sk)
-{
-  size_t i;
-  int ret;
+int crypto_sign_seed_expand(uint8_t *sk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]) {
+  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
 
-  for(i = 0; i < mlen; ++i)
-    sm[CRYPTO_BYTES + mlen - 1 - i] = m[mlen - 1 - i];
-  ret = crypto_sign_signature(sm, smlen, sm + CRYPTO_BYTES, mlen, ctx, ctxlen, sk);
-  *smlen += mlen;
-  return ret;
+  return crypto_sign_seed_keypair(pk, sk, seed);
 }
 
 /*************************************************
-* Name:        crypto_sign_verify_internal
+* Name:        crypto_sign_seed_expand_sk
 *
-* Description: Verifies signature. Internal API.
+* Description: Expands seed-only secret key directly into signing context,
+*              without packing and unpacking a full secret key. Result is
+*              identical to crypto_sign_expand_sk on the key generated by
+*              crypto_sign_seed_keypair from the same seed.
 *
-* Arguments:   - uint8_t *m: pointer to input signature
-*              - size_t siglen: length of signature
-*              - const uint8_t *m: pointer to message
-*              - size_t mlen: length of message
-*              - const uint8_t *pre: pointer to prefix string
-*              - size_t prelen: length of prefix string
-*              - const uint8_t *pk: pointer to bit-packed public key
+* Arguments:   - expanded_sk *esk: pointer to output expanded secret key
+*              - const uint8_t *seed: pointer to seed-only secret key
+*                                     (of length CRYPTO_SEEDKEYBYTES)
 *
-* Returns 0 if signature could be verified correctly and -1 otherwise
+* Returns 0 (success)
 **************************************************/
-int crypto_sign_verify_internal(const uint8_t *sig, size_t siglen, const uint8_t *m, size_t mlen,
-                                const uint8_t *pre, size_t prelen, const uint8_t *pk) {
-  unsigned int i, j, pos = 0;
-  /* polyw1_pack writes additional 14 bytes */
-  ALIGNED_UINT8(K*POLYW1_PACKEDBYTES+14) buf;
-  uint8_t mu[CRHBYTES];
-  const uint8_t *hint = sig + CTILDEBYTES + L*POLYZ_PACKEDBYTES;
-  polyvecl rowbuf[2];
-  polyvecl *row = rowbuf;
-  polyvecl z;
-  poly c, w1, h;
-  keccak_state state;
+int crypto_sign_seed_expand_sk(expanded_sk *esk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]) {
+  unsigned int i;
+  uint8_t seedbuf[2*SEEDBYTES + CRHBYTES];
+  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
+  const uint8_t *rho, *rhoprime, *key;
+  polyvecl *s1 = &esk->s1, s1hat;
+  polyveck *s2 = &esk->s2;
+  poly t1;
+#if K != L
+  poly tmp;
+#endif
 
-  if(siglen != CRYPTO_BYTES)
-    return -1;
+  /* Expand seed to rho, rhoprime and key */
+  memcpy(seedbuf, seed, SEEDBYTES);
+  seedbuf[SEEDBYTES+0] = K;
+  seedbuf[SEEDBYTES+1] = L;
+  shake256(seedbuf, 2*SEEDBYTES + CRHBYTES, seedbuf, SEEDBYTES+2);
+  rho = seedbuf;
+  rhoprime = rho + SEEDBYTES;
+  key = rhoprime + CRHBYTES;
 
-  /* Compute CRH(H(rho, t1), pre, msg) */
-  shake256(mu, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
-  shake256_init(&state);
-  shake256_absorb(&state, mu, CRHBYTES);
-  shake256_absorb(&state, pre, prelen);
-  shake256_absorb(&state, m, mlen);
-  shake256_finalize(&state);
-  shake256_squeeze(mu, CRHBYTES, &state);
+  /* Store rho, key */
+  memcpy(pk, rho, SEEDBYTES);
+  memcpy(esk->key, key, SEEDBYTES);
 
-  /* Expand challenge */
-  poly_challenge(&c, sig);
-  poly_ntt(&c);
+  /* Sample short vectors s1 and s2 */
+#if K == 4 && L == 4
+  poly_uniform_eta_4x(&s1->vec[0], &s1->vec[1], &s1->vec[2], &s1->vec[3], rhoprime, 0, 1, 2, 3);
+  poly_uniform_eta_4x(&s2->vec[0], &s2->vec[1], &s2->vec[2], &s2->vec[3], rhoprime, 4, 5, 6, 7);
+#elif K == 6 && L == 5
+  poly_uniform_eta_4x(&s1->vec[0], &s1->vec[1], &s1->vec[2], &s1->vec[3], rhoprime, 0, 1, 2, 3);
+  poly_uniform_eta_4x(&s1->vec[4], &s2->vec[0], &s2->vec[1], &s2->vec[2], rhoprime, 4, 5, 6, 7);
+  poly_uniform_eta_4x(&s2->vec[3], &s2->vec[4], &s2->vec[5], &tmp, rhoprime, 8, 9, 10, 11);
+#elif K == 8 && L == 7
+  poly_uniform_eta_4x(&s1->vec[0], &s1->vec[1], &s1->vec[2], &s1->vec[3], rhoprime, 0, 1, 2, 3);
+  poly_uniform_eta_4x(&s1->vec[4], &s1->vec[5], &s1->vec[6], &s2->vec[0], rhoprime, 4, 5, 6, 7);
+  poly_uniform_eta_4x(&s2->vec[1], &s2->vec[2], &s2->vec[3], &s2->vec[4], rhoprime, 8, 9, 10, 11);
+  poly_uniform_eta_4x(&s2->vec[5], &s2->vec[6], &s2->vec[7], &tmp, rhoprime, 12, 13, 14, 15);
+#else
+#error
+#endif
 
-  /* Unpack z; shortness follows from unpacking */
-  for(i = 0; i < L; i++) {
-    polyz_unpack(&z.vec[i], sig + CTILDEBYTES + i*POLYZ_PACKEDBYTES);
-    poly_ntt(&z.vec[i]);
-  }
+  /* Expand matrix and transform s1 */
+  polyvec_matrix_expand(esk->mat, rho);
+  s1hat = *s1;
+  polyvecl_ntt(&s1hat);
 
   for(i = 0; i < K; i++) {
-    /* Expand matrix row */
-    polyvec_matrix_expand_row(&row, rowbuf, pk, i);
-
-    /* Compute i-th row of Az - c2^Dt1 */
-    polyvecl_pointwise_acc_montgomery(&w1, row, &z);
-
-    polyt1_unpack(&h, pk + SEEDBYTES + i*POLYT1_PACKEDBYTES);
-    poly_shiftl(&h);
-    poly_ntt(&h);
-    poly_pointwise_montgomery(&h, &c, &h);
-
-    poly_sub(&w1, &w1, &h);
-    poly_reduce(&w1);
-    poly_invntt_tomont(&w1);
-
-    /* Get hint polynomial and reconstruct w1 */
-    memset(h.vec, 0, sizeof(poly));
-    if(hint[OMEGA + i] < pos || hint[OMEGA + i] > OMEGA)
-      return -1;
+    /* Compute inner-product */
+    polyvecl_pointwise_acc_invntt_tomont(&t1, &esk->mat[i], &s1hat);
 
-    for(j = pos; j < hint[OMEGA + i]; ++j) {
-      /* Coefficients are ordered for strong unforgeability */
-      if(j > pos && hint[j] <= hint[j-1]) return -1;
-      h.coeffs[hint[j]] = 1;
-    }
-    pos = hint[OMEGA + i];
+    /* Add error polynomial */
+    poly_add(&t1, &t1, &s2->vec[i]);
 
-    poly_caddq(&w1);
-    poly_use_hint(&w1, &w1, &h);
-    polyw1_pack(buf.coeffs + i*POLYW1_PACKEDBYTES, &w1);
+    /* Round t and pack t1 */
+    poly_caddq(&t1);
+    poly_power2round(&t1, &esk->t0.vec[i], &t1);
+    polyt1_pack(pk + SEEDBYTES + i*POLYT1_PACKEDBYTES, &t1);
   }
 
-  /* Extra indices are zero for strong unforgeability */
-  for(j = pos; j < OMEGA; ++j)
-    if(hint[j]) return -1;
+  /* Compute H(rho, t1) */
+  shake256(esk->tr, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
 
-  /* Call random oracle and verify challenge */
-  shake256_init(&state);
-  shake256_absorb(&state, mu, CRHBYTES);
-  shake256_absorb(&state, buf.coeffs, K*POLYW1_PACKEDBYTES);
-  shake256_finalize(&state);
-  shake256_squeeze(buf.coeffs, CTILDEBYTES, &state);
-  for(i = 0; i < CTILDEBYTES; ++i)
-    if(buf.coeffs[i] != sig[i])
-      return -1;
+  /* Transform t0 */
+  polyveck_ntt(&esk->t0);
 
   return 0;
 }
 
 /*************************************************
-* Name:        crypto_sign_verify
+* Name:        crypto_sign_expand_sk
 *
-* Description: Verifies signature.
+* Description: Expands bit-packed secret key into signing context holding
+*              matrix A and vector t0 in NTT domain and vectors s1, s2, so
+*              that repeated signing under the same key can skip unpacking,
+*              matrix expansion and forward NTTs.
 *
-* Arguments:   - uint8_t *m: pointer to input signature
-*              - size_t siglen: length of signature
-*              - const uint8_t *m: pointer to message
-*              - size_t mlen: length of message
-*              - const uint8_t *ctx: pointer to context string
-*              - size_t ctxlen: length of context string
-*              - const uint8_t *pk: pointer to bit-packed public key
+* Arguments:   - expanded_sk *esk: pointer to output expanded secret key
+*              - uint8_t *sk: pointer to bit-packed secret key
 *
-* Returns 0 if signature could be verified correctly and -1 otherwise
+* Returns 0 (success)
 **************************************************/
-int crypto_sign_verify(const uint8_t *sig, size_t siglen, const uint8_t *m, size_t mlen,
-                       const uint8_t *ctx, size_t ctxlen, const uint8_t *pk)
+int crypto_sign_expand_sk(expanded_sk *esk, const uint8_t *sk)
 {
-  uint8_t pre[257];
+  uint8_t rho[SEEDBYTES];
 
-  if(ctxlen > 255)
-    return -1;
+  unpack_sk(rho, esk->tr, esk->key, &esk->t0, &esk->s1, &esk->s2, sk);
 
-  pre[0] = 0;
-  pre[1] = ctxlen;
-  memcpy(&pre[2], ctx, ctxlen);
-  return crypto_sign_verify_internal(sig,siglen,m,mlen,pre,2+ctxlen,pk);
+  /* Expand matrix and transform t0 */
+  polyvec_matrix_expand(esk->mat, rho);
+  polyveck_ntt(&esk->t0);
+
+  return 0;
 }
 
 /*************************************************
-* Name:        crypto_sign_open
+* Name:        finish_signature
+*
+* Description: Completes one signing attempt after the challenge has been
+*              derived: computes z = y + cs1 and the hints, and packs them
+*              into the signature unless the attempt has to be rejected.
+*
+* Arguments:   - uint8_t *sig: pointer to signature holding c tilde
+*              - polyvecl *z: pointer to y on input, z on output
+*              - polyveck *w0: pointer to low part of w
+*              - const polyveck *w1: pointer to high part of w
+*              - poly *c: pointer to challenge; transformed to NTT domain
+*              - const expanded_sk *esk: pointer to expanded secret key
+*
+* Returns 0 if signature is complete and -1 if attempt was rejected
+**************************************************/
+static int finish_signature(uint8_t *sig, polyvecl *z, polyveck *w0, const polyveck *w1, poly *c,
+                            const expanded_sk *esk)
+{
+  unsigned int i, n, pos;
+  uint8_t hintbuf[N];
+  uint8_t *hint = sig + CTILDEBYTES + L*POLYZ_PACKEDBYTES;
+  poly tmp;
+  sparse_poly sc;
+
+  /* The products with s1 and s2 are computed exactly from the TAU nonzero
+   * coefficients of c, only c*t0 goes through the NTT */
+  poly_challenge_sparse(&sc, c);
+  poly_ntt(c);
+
+  /* Compute z, reject if it reveals secret */
+  for(i = 0; i < L; i++) {
+    poly_sparse_mul_eta(&tmp, &sc, &esk->s1.vec[i]);
+    poly_add(&z->vec[i], &z->vec[i], &tmp);
+    if(poly_chknorm(&z->vec[i], GAMMA1 - BETA))
+      return -1;
+  }
+
+  /* Zero hint vector in signature */
+  pos = 0;
+  memset(hint, 0, OMEGA);
+
+  for(i = 0; i < K; i++) {
+    /* Check that subtracting cs2 does not change high bits of w and low bits
+     * do not reveal secret information */
+    poly_sparse_mul_eta(&tmp, &sc, &esk->s2.vec[i]);
+    poly_sub(&w0->vec[i], &w0->vec[i], &tmp);
+    if(poly_chknorm(&w0->vec[i], GAMMA2 - BETA))
+      return -1;
+
+    /* Compute hints */
+    poly_pointwise_montgomery(&tmp, c, &esk->t0.vec[i]);
+    poly_invntt_tomont(&tmp);
+    poly_reduce(&tmp);
+    if(poly_chknorm(&tmp, GAMMA2))
+      return -1;
+
+    poly_add(&w0->vec[i], &w0->vec[i], &tmp);
+    n = poly_make_hint(hintbuf, &w0->vec[i], &w1->vec[i]);
+    if(pos + n > OMEGA)
+      return -1;
+
+    /* Store hints in signature */
+    memcpy(&hint[pos], hintbuf, n);
+    hint[OMEGA + i] = pos = pos + n;
+  }
+
+  /* Pack z into signature */
+  for(i = 0; i < L; i++)
+    polyz_pack(sig + CTILDEBYTES + i*POLYZ_PACKEDBYTES, &z->vec[i]);
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_attempt
+*
+* Description: Runs one iteration of the rejection loop of signing.
+*              Internal API.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - const uint8_t mu[]: message representative (of length CRHBYTES)
+*              - const uint8_t rhoprime[]: seed of masking vector
+*                                          (of length CRHBYTES)
+*              - uint16_t nonce: number of the attempt, starting from 0
+*              - const expanded_sk *esk: pointer to expanded secret key
+*
+* Returns 0 if the signature was accepted and -1 if it was rejected
+**************************************************/
+int crypto_sign_signature_attempt(uint8_t sig[CRYPTO_BYTES],
+                                  const uint8_t mu[CRHBYTES],
+                                  const uint8_t rhoprime[CRHBYTES],
+                                  uint16_t nonce,
+                                  const expanded_sk *esk)
+{
+  polyvecl z;
+  polyveck w1;
+  poly c;
+  union {
+    polyvecl y;
+    polyveck w0;
+  } tmpv;
+  keccak_state state;
+
+  /* Sample intermediate vector y */
+#if L == 4
+  poly_uniform_gamma1_4x(&z.vec[0], &z.vec[1], &z.vec[2], &z.vec[3],
+                         rhoprime, L*nonce, L*nonce + 1, L*nonce + 2, L*nonce + 3);
+#elif L == 5
+  poly_uniform_gamma1_4x(&z.vec[0], &z.vec[1], &z.vec[2], &z.vec[3],
+                         rhoprime, L*nonce, L*nonce + 1, L*nonce + 2, L*nonce + 3);
+  poly_uniform_gamma1(&z.vec[4], rhoprime, L*nonce + 4);
+#elif L == 7
+  if(fips202x8_available()) {
+    poly *y[8] = {&z.vec[0], &z.vec[1], &z.vec[2], &z.vec[3], &z.vec[4], &z.vec[5], &z.vec[6], &c};
+    const uint16_t ynonce[8] = {L*nonce, L*nonce + 1, L*nonce + 2, L*nonce + 3,
+                                L*nonce + 4, L*nonce + 5, L*nonce + 6, 0};
+    poly_uniform_gamma1_8x(y, rhoprime, ynonce);
+  }
+  else {
+    poly_uniform_gamma1_4x(&z.vec[0], &z.vec[1], &z.vec[2], &z.vec[3],
+                           rhoprime, L*nonce, L*nonce + 1, L*nonce + 2, L*nonce + 3);
+    poly_uniform_gamma1_4x(&z.vec[4], &z.vec[5], &z.vec[6], &c,
+                           rhoprime, L*nonce + 4, L*nonce + 5, L*nonce + 6, 0);
+  }
+#else
+#error
+#endif
+
+  /* Matrix-vector product */
+  tmpv.y = z;
+  polyvecl_ntt(&tmpv.y);
+  polyvec_matrix_pointwise_montgomery(&w1, esk->mat, &tmpv.y);
+  polyveck_invntt_tomont(&w1);
+
+  /* Decompose w and call the random oracle */
+  polyveck_caddq(&w1);
+  polyveck_decompose(&w1, &tmpv.w0, &w1);
+  polyveck_pack_w1(sig, &w1);
+
+  shake256_init(&state);
+  shake256_absorb(&state, mu, CRHBYTES);
+  shake256_absorb(&state, sig, K*POLYW1_PACKEDBYTES);
+  shake256_finalize(&state);
+  shake256_squeeze(sig, CTILDEBYTES, &state);
+  poly_challenge(&c, sig);
+
+  /* Compute z and hints, reject if they reveal secret */
+  return finish_signature(sig, &z, &tmpv.w0, &w1, &c, esk);
+}
+
+/*************************************************
+* Name:        sign_mu
+*
+* Description: Computes signature for message representative mu by
+*              running the rejection loop from attempt 0.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - const uint8_t *mu: pointer to message representative
+*              - uint8_t *rnd: pointer to random seed
+*              - expanded_sk *esk: pointer to expanded secret key
+**************************************************/
+static void sign_mu(uint8_t sig[CRYPTO_BYTES],
+                    const uint8_t mu[CRHBYTES],
+                    const uint8_t rnd[RNDBYTES],
+                    const expanded_sk *esk)
+{
+  uint8_t rhoprime[CRHBYTES];
+  uint16_t nonce = 0;
+  keccak_state state;
+
+  /* Compute rhoprime = CRH(key, rnd, mu) */
+  shake256_init(&state);
+  shake256_absorb(&state, esk->key, SEEDBYTES);
+  shake256_absorb(&state, rnd, RNDBYTES);
+  shake256_absorb(&state, mu, CRHBYTES);
+  shake256_finalize(&state);
+  shake256_squeeze(rhoprime, CRHBYTES, &state);
+
+  while(crypto_sign_signature_attempt(sig, mu, rhoprime, nonce++, esk));
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_expanded_internal
+*
+* Description: Computes signature from expanded secret key. Internal API.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m: pointer to message to be signed
+*              - size_t mlen: length of message
+*              - uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - uint8_t *rnd: pointer to random seed
+*              - expanded_sk *esk: pointer to expanded secret key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_signature_expanded_internal(uint8_t *sig, size_t *siglen, const uint8_t *m, size_t mlen,
+                                            const uint8_t *pre, size_t prelen, const uint8_t rnd[RNDBYTES],
+                                            const expanded_sk *esk)
+{
+  uint8_t mu[CRHBYTES];
+  keccak_state state;
+
+  /* Compute mu = CRH(tr, pre, msg) */
+  shake256_init(&state);
+  shake256_absorb(&state, esk->tr, TRBYTES);
+  shake256_absorb(&state, pre, prelen);
+  shake256_absorb(&state, m, mlen);
+  shake256_finalize(&state);
+  shake256_squeeze(mu, CRHBYTES, &state);
+
+  sign_mu(sig, mu, rnd, esk);
+
+  *siglen = CRYPTO_BYTES;
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_internal
+*
+* Description: Computes signature. Internal API.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m: pointer to message to be signed
+*              - size_t mlen: length of message
+*              - uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - uint8_t *rnd: pointer to random seed
+*              - uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_signature_internal(uint8_t *sig, size_t *siglen, const uint8_t *m, size_t mlen,
+                                   const uint8_t *pre, size_t prelen, const uint8_t rnd[RNDBYTES], const uint8_t *sk)
+{
+  expanded_sk esk;
+
+  crypto_sign_expand_sk(&esk, sk);
+  return crypto_sign_signature_expanded_internal(sig, siglen, m, mlen, pre, prelen, rnd, &esk);
+}
+
+/*************************************************
+* Name:        crypto_sign_signature
+*
+* Description: Computes signature.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m: pointer to message to be signed
+*              - size_t mlen: length of message
+*              - uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_signature(uint8_t *sig, size_t *siglen, const uint8_t *m, size_t mlen,
+                          const uint8_t *ctx, size_t ctxlen, const uint8_t *sk)
+{
+  uint8_t pre[257];
+  uint8_t rnd[RNDBYTES];
+
+  if(ctxlen > 255)
+    return -1;
+
+  /* Prepare pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  memcpy(&pre[2], ctx, ctxlen);
+
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+  randombytes(rnd, RNDBYTES);
+#else
+  memset(rnd, 0, RNDBYTES);
+#endif
+
+  crypto_sign_signature_internal(sig,siglen,m,mlen,pre,2+ctxlen,rnd,sk);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_expanded
+*
+* Description: Computes signature from expanded secret key. Output is
+*              identical to crypto_sign_signature with the same key.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m: pointer to message to be signed
+*              - size_t mlen: length of message
+*              - uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - expanded_sk *esk: pointer to expanded secret key
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_signature_expanded(uint8_t *sig, size_t *siglen, const uint8_t *m, size_t mlen,
+                                   const uint8_t *ctx, size_t ctxlen, const expanded_sk *esk)
+{
+  uint8_t pre[257];
+  uint8_t rnd[RNDBYTES];
+
+  if(ctxlen > 255)
+    return -1;
+
+  /* Prepare pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  memcpy(&pre[2], ctx, ctxlen);
+
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+  randombytes(rnd, RNDBYTES);
+#else
+  memset(rnd, 0, RNDBYTES);
+#endif
+
+  crypto_sign_signature_expanded_internal(sig,siglen,m,mlen,pre,2+ctxlen,rnd,esk);
+  return 0;
+}
+
+/*************************************************
+* Name:        crh_x4
+*
+* Description: Computes mu = CRH(tr, pre, msg) for four independent inputs
+*              of possibly different lengths with the incremental 4-way
+*              SHAKE256 implementation.
+*
+* Arguments:   - uint8_t mu[4][CRHBYTES]: output array
+*              - uint8_t tr[4][TRBYTES]: public key hashes
+*              - const uint8_t *pre[4]: prefix strings
+*              - const size_t prelen[4]: lengths of prefix strings
+*              - const uint8_t *m[4]: messages
+*              - const size_t mlen[4]: lengths of messages
+**************************************************/
+static void crh_x4(uint8_t mu[4][CRHBYTES], uint8_t tr[4][TRBYTES],
+                   const uint8_t *pre[4], const size_t prelen[4],
+                   const uint8_t *m[4], const size_t mlen[4])
+{
+  unsigned int k;
+  const uint8_t *in[4];
+  uint8_t *out[4];
+  size_t len[4];
+  keccakx4_state state;
+
+  for(k = 0; k < 4; ++k) {
+    in[k] = tr[k];
+    out[k] = mu[k];
+    len[k] = TRBYTES;
+  }
+
+  shake256x4_init(&state);
+  shake256x4_absorb(&state, in, len);
+  shake256x4_absorb(&state, pre, prelen);
+  shake256x4_absorb(&state, m, mlen);
+  shake256x4_finalize(&state);
+
+  for(k = 0; k < 4; ++k)
+    len[k] = CRHBYTES;
+  shake256x4_squeeze(out, len, &state);
+}
+
+/*************************************************
+* Name:        seed_lanes_x4
+*
+* Description: Computes mu = CRH(tr, pre, msg) and rhoprime =
+*              CRH(key, rnd, mu) of up to four messages with the 4-way
+*              SHAKE256 implementation. Unused lanes repeat the first
+*              message.
+*
+* Arguments:   - uint8_t mu[4][CRHBYTES]: output array of mu
+*              - uint8_t rhoprime[4][CRHBYTES]: output array of rhoprime
+*              - const uint8_t *const m[]: array of messages
+*              - const size_t mlen[]: array of message lengths
+*              - const uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - const uint8_t *const rnd[]: array of random seeds
+*              - const expanded_sk *esk: pointer to expanded secret key
+*              - size_t cnt: number of messages (at most 4)
+**************************************************/
+static void seed_lanes_x4(uint8_t mu[4][CRHBYTES], uint8_t rhoprime[4][CRHBYTES],
+                          const uint8_t *const m[], const size_t mlen[],
+                          const uint8_t *pre, size_t prelen,
+                          const uint8_t *const rnd[], const expanded_sk *esk, size_t cnt)
+{
+  unsigned int k;
+  size_t l;
+  uint8_t tr[4][TRBYTES];
+  uint8_t inbuf[4][SEEDBYTES + RNDBYTES + CRHBYTES];
+  const uint8_t *prex[4], *mx[4];
+  size_t prelenx[4], mlenx[4];
+
+  for(k = 0; k < 4; ++k) {
+    l = (k < cnt) ? k : 0;
+    memcpy(tr[k], esk->tr, TRBYTES);
+    prex[k] = pre;
+    prelenx[k] = prelen;
+    mx[k] = m[l];
+    mlenx[k] = mlen[l];
+  }
+
+  /* Compute mu = CRH(tr, pre, msg) */
+  crh_x4(mu, tr, prex, prelenx, mx, mlenx);
+
+  /* Compute rhoprime = CRH(key, rnd, mu) */
+  for(k = 0; k < 4; ++k) {
+    l = (k < cnt) ? k : 0;
+    memcpy(inbuf[k], esk->key, SEEDBYTES);
+    memcpy(inbuf[k] + SEEDBYTES, rnd[l], RNDBYTES);
+    memcpy(inbuf[k] + SEEDBYTES + RNDBYTES, mu[k], CRHBYTES);
+  }
+  shake256x4(rhoprime[0], rhoprime[1], rhoprime[2], rhoprime[3], CRHBYTES,
+             inbuf[0], inbuf[1], inbuf[2], inbuf[3], SEEDBYTES + RNDBYTES + CRHBYTES);
+}
+
+typedef struct {
+  size_t idx;
+  uint16_t nonce;
+  /* polyveck_pack_w1 writes additional 14 bytes */
+  ALIGNED_UINT8(CRHBYTES + K*POLYW1_PACKEDBYTES + 14) buf;
+  uint8_t rhoprime[CRHBYTES];
+  polyvecl z;
+  union {
+    polyvecl y;
+    polyveck w0;
+  } tmpv;
+  polyveck w1;
+  poly c;
+} sign_lane;
+
+/*************************************************
+* Name:        crypto_sign_signature_batch_internal
+*
+* Description: Computes signatures of n messages under one expanded secret
+*              key. Signature i equals the output of
+*              crypto_sign_signature_expanded_internal on message i with
+*              randomness rnd[i]. Internal API.
+*
+* Arguments:   - uint8_t *const sig[]: array of n output signatures
+*                                      (of length CRYPTO_BYTES)
+*              - size_t siglen[]: array of output signature lengths
+*              - const uint8_t *const m[]: array of n messages
+*              - const size_t mlen[]: array of message lengths
+*              - const uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - const uint8_t *const rnd[]: array of n random seeds
+*                                            (of length RNDBYTES)
+*              - const expanded_sk *esk: pointer to expanded secret key
+*              - size_t n: number of messages
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_signature_batch_internal(uint8_t *const sig[], size_t siglen[],
+                                         const uint8_t *const m[], const size_t mlen[],
+                                         const uint8_t *pre, size_t prelen,
+                                         const uint8_t *const rnd[],
+                                         const expanded_sk *esk, size_t n)
+{
+  unsigned int j, k, active;
+  size_t next = 0, qpos = 0, qcnt = 0;
+  uint8_t qmu[4][CRHBYTES], qrhoprime[4][CRHBYTES];
+  uint8_t scratch[4][CTILDEBYTES];
+  uint8_t *out[4];
+  sign_lane lane[4];
+
+  /* Lanes that never get a message sample and hash fixed all-zero input;
+   * other idle lanes reuse their last input. Output is ignored */
+  for(k = 0; k < 4; ++k) {
+    lane[k].idx = SIZE_MAX;
+    lane[k].nonce = 0;
+    memset(lane[k].buf.coeffs, 0, sizeof(lane[k].buf));
+    memset(lane[k].rhoprime, 0, CRHBYTES);
+  }
+
+  for(;;) {
+    /* Move next messages into idle lanes */
+    active = 0;
+    for(k = 0; k < 4; ++k) {
+      if(lane[k].idx == SIZE_MAX && next < n) {
+        if(qpos == qcnt) {
+          qcnt = (n - next < 4) ? n - next : 4;
+          seed_lanes_x4(qmu, qrhoprime, m + next, mlen + next, pre, prelen, rnd + next, esk, qcnt);
+          qpos = 0;
+        }
+        lane[k].idx = next++;
+        lane[k].nonce = 0;
+        memcpy(lane[k].buf.coeffs, qmu[qpos], CRHBYTES);
+        memcpy(lane[k].rhoprime, qrhoprime[qpos], CRHBYTES);
+        qpos++;
+      }
+      active += (lane[k].idx != SIZE_MAX);
+    }
+
+    if(!active)
+      break;
+
+    /* Sample intermediate vectors y of all lanes */
+    for(j = 0; j < L; ++j)
+      poly_uniform_gamma1_4x_seeds(&lane[0].z.vec[j], &lane[1].z.vec[j], &lane[2].z.vec[j], &lane[3].z.vec[j],
+                                   lane[0].rhoprime, lane[1].rhoprime, lane[2].rhoprime, lane[3].rhoprime,
+                                   lane[0].nonce + j, lane[1].nonce + j, lane[2].nonce + j, lane[3].nonce + j);
+
+    for(k = 0; k < 4; ++k) {
+      if(lane[k].idx == SIZE_MAX) {
+        out[k] = scratch[k];
+        continue;
+      }
+      out[k] = sig[lane[k].idx];
+      lane[k].nonce += L;
+
+      /* Matrix-vector product */
+      lane[k].tmpv.y = lane[k].z;
+      polyvecl_ntt(&lane[k].tmpv.y);
+      polyvec_matrix_pointwise_montgomery(&lane[k].w1, esk->mat, &lane[k].tmpv.y);
+      polyveck_invntt_tomont(&lane[k].w1);
+
+      /* Decompose w */
+      polyveck_caddq(&lane[k].w1);
+      polyveck_decompose(&lane[k].w1, &lane[k].tmpv.w0, &lane[k].w1);
+      polyveck_pack_w1(lane[k].buf.coeffs + CRHBYTES, &lane[k].w1);
+    }
+
+    /* Call the random oracle */
+    shake256x4(out[0], out[1], out[2], out[3], CTILDEBYTES,
+               lane[0].buf.coeffs, lane[1].buf.coeffs, lane[2].buf.coeffs, lane[3].buf.coeffs,
+               CRHBYTES + K*POLYW1_PACKEDBYTES);
+    poly_challenge_4x(&lane[0].c, &lane[1].c, &lane[2].c, &lane[3].c, out[0], out[1], out[2], out[3]);
+
+    for(k = 0; k < 4; ++k) {
+      if(lane[k].idx == SIZE_MAX)
+        continue;
+
+      /* Compute z and hints, retry lane if they reveal secret */
+      if(finish_signature(out[k], &lane[k].z, &lane[k].tmpv.w0, &lane[k].w1, &lane[k].c, esk))
+        continue;
+
+      siglen[lane[k].idx] = CRYPTO_BYTES;
+      lane[k].idx = SIZE_MAX;
+    }
+  }
+
+  return 0;
+}
+
+/* Messages sharing one buffer of fresh randomness in
+ * crypto_sign_signature_batch */
+#define SIGN_BATCH_CHUNK 32
+
+/*************************************************
+* Name:        crypto_sign_signature_batch
+*
+* Description: Computes signatures of n messages under one secret key,
+*              unpacking and expanding the key only once.
+*
+* Arguments:   - uint8_t *const sig[]: array of n output signatures
+*                                      (of length CRYPTO_BYTES)
+*              - size_t siglen[]: array of output signature lengths
+*              - const uint8_t *const m[]: array of n messages
+*              - const size_t mlen[]: array of message lengths
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*              - size_t n: number of messages
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_signature_batch(uint8_t *const sig[], size_t siglen[],
+                                const uint8_t *const m[], const size_t mlen[],
+                                const uint8_t *ctx, size_t ctxlen,
+                                const uint8_t *sk, size_t n)
+{
+  size_t i, cnt;
+  uint8_t pre[257];
+  uint8_t rndbuf[SIGN_BATCH_CHUNK][RNDBYTES];
+  const uint8_t *rnd[SIGN_BATCH_CHUNK];
+  expanded_sk esk;
+
+  if(ctxlen > 255)
+    return -1;
+
+  /* Prepare pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  memcpy(&pre[2], ctx, ctxlen);
+
+  crypto_sign_expand_sk(&esk, sk);
+
+  for(i = 0; i < SIGN_BATCH_CHUNK; ++i)
+    rnd[i] = rndbuf[i];
+
+  for(i = 0; i < n; i += cnt) {
+    cnt = (n - i < SIGN_BATCH_CHUNK) ? n - i : SIGN_BATCH_CHUNK;
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+    randombytes(rndbuf[0], cnt*RNDBYTES);
+#else
+    memset(rndbuf, 0, cnt*RNDBYTES);
+#endif
+    crypto_sign_signature_batch_internal(sig + i, siglen + i, m + i, mlen + i, pre, 2 + ctxlen,
+                                         rnd, &esk, cnt);
+  }
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_init
+*
+* Description: Starts incremental signing. The message is passed in
+*              chunks to crypto_sign_update and the signature is computed
+*              by crypto_sign_final. Output is a signature of the
+*              concatenated chunks as computed by crypto_sign_signature.
+*
+* Arguments:   - sign_state *state: pointer to output signing state
+*              - const uint8_t *sk: pointer to bit-packed secret key; must
+*                                   stay valid until crypto_sign_final
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_init(sign_state *state, const uint8_t *sk,
+                     const uint8_t *ctx, size_t ctxlen)
+{
+  uint8_t pre[2];
+
+  if(ctxlen > 255)
+    return -1;
+
+  /* Start mu = CRH(tr, pre, msg) with pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  state->sk = sk;
+  shake256_init(&state->mu);
+  shake256_absorb(&state->mu, sk + 2*SEEDBYTES, TRBYTES);
+  shake256_absorb(&state->mu, pre, 2);
+  shake256_absorb(&state->mu, ctx, ctxlen);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_update
+*
+* Description: Absorbs next chunk of the message to be signed.
+*
+* Arguments:   - sign_state *state: pointer to signing state
+*              - const uint8_t *m: pointer to message chunk
+*              - size_t mlen: length of message chunk
+**************************************************/
+void crypto_sign_update(sign_state *state, const uint8_t *m, size_t mlen) {
+  shake256_absorb(&state->mu, m, mlen);
+}
+
+/*************************************************
+* Name:        crypto_sign_final
+*
+* Description: Computes signature of all absorbed message chunks.
+*
+* Arguments:   - sign_state *state: pointer to signing state
+*              - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_final(sign_state *state, uint8_t *sig, size_t *siglen) {
+  uint8_t mu[CRHBYTES];
+
+  shake256_finalize(&state->mu);
+  shake256_squeeze(mu, CRHBYTES, &state->mu);
+
+  return crypto_sign_signature_extmu(sig, siglen, mu, state->sk);
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_iov
+*
+* Description: Computes signature of message given as list of segments.
+*              The segments are absorbed in order without being copied
+*              into one buffer. Output is a signature of the concatenated
+*              segments as computed by crypto_sign_signature.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - const sign_iovec *iov: pointer to array of message segments
+*              - size_t iovcnt: number of message segments
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_signature_iov(uint8_t *sig, size_t *siglen,
+                              const sign_iovec *iov, size_t iovcnt,
+                              const uint8_t *ctx, size_t ctxlen,
+                              const uint8_t *sk)
+{
+  size_t i;
+  sign_state state;
+
+  if(crypto_sign_init(&state, sk, ctx, ctxlen))
+    return -1;
+  for(i = 0; i < iovcnt; ++i)
+    crypto_sign_update(&state, iov[i].base, iov[i].len);
+  return crypto_sign_final(&state, sig, siglen);
+}
+
+/*************************************************
+* Name:        crypto_sign_compute_mu
+*
+* Description: Computes message representative mu = CRH(H(pk), pre, msg)
+*              with pre = (0, ctxlen, ctx) for use with
+*              crypto_sign_signature_extmu and crypto_sign_verify_extmu.
+*
+* Arguments:   - uint8_t *mu: pointer to output message representative
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_compute_mu(uint8_t mu[CRHBYTES],
+                           const uint8_t *m, size_t mlen,
+                           const uint8_t *ctx, size_t ctxlen,
+                           const uint8_t *pk)
+{
+  uint8_t pre[2];
+  keccak_state state;
+
+  if(ctxlen > 255)
+    return -1;
+
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  shake256(mu, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+  shake256_init(&state);
+  shake256_absorb(&state, mu, TRBYTES);
+  shake256_absorb(&state, pre, 2);
+  shake256_absorb(&state, ctx, ctxlen);
+  shake256_absorb(&state, m, mlen);
+  shake256_finalize(&state);
+  shake256_squeeze(mu, CRHBYTES, &state);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_extmu
+*
+* Description: Computes signature for externally computed message
+*              representative mu.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - const uint8_t *mu: pointer to message representative
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_signature_extmu(uint8_t *sig, size_t *siglen,
+                                const uint8_t mu[CRHBYTES],
+                                const uint8_t *sk)
+{
+  uint8_t rnd[RNDBYTES];
+  expanded_sk esk;
+
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+  randombytes(rnd, RNDBYTES);
+#else
+  memset(rnd, 0, RNDBYTES);
+#endif
+
+  crypto_sign_expand_sk(&esk, sk);
+  sign_mu(sig, mu, rnd, &esk);
+
+  *siglen = CRYPTO_BYTES;
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign
+*
+* Description: Compute signed message.
+*
+* Arguments:   - uint8_t *sm: pointer to output signed message (allocated
+*                             array with CRYPTO_BYTES + mlen bytes),
+*                             can be equal to m
+*              - size_t *smlen: pointer to output length of signed
+*                               message
+*              - const uint8_t *m: pointer to message to be signed
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign(uint8_t *sm, size_t *smlen, const uint8_t *m, size_t mlen, const uint8_t *ctx, size_t ctxlen,
+                const uint8_t *sk)
+{
+  int ret;
+
+  /* Message may already be in place or overlap sm */
+  if(sm + CRYPTO_BYTES != m)
+    memmove(sm + CRYPTO_BYTES, m, mlen);
+  ret = crypto_sign_signature(sm, smlen, sm + CRYPTO_BYTES, mlen, ctx, ctxlen, sk);
+  *smlen += mlen;
+  return ret;
+}
+
+/*************************************************
+* Name:        unpack_and_check_sig
+*
+* Description: Unpacks signature and checks its length, the norm of z and
+*              the encoding of the hints. All verifiers, including the
+*              4-way batch verifier, decode signatures only through here.
+*
+* Arguments:   - uint8_t *c: pointer to output challenge seed
+*              - polyvecl *z: pointer to output vector z
+*              - polyveck *h: pointer to output hint vector h
+*              - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*
+* Returns 0 if signature is well-formed and -1 otherwise
+**************************************************/
+static int unpack_and_check_sig(uint8_t c[CTILDEBYTES], polyvecl *z, polyveck *h,
+                                const uint8_t *sig, size_t siglen)
+{
+  if(siglen != CRYPTO_BYTES)
+    return -1;
+
+  if(unpack_sig(c, z, h, sig))
+    return -1;
+  if(polyvecl_chknorm(z, GAMMA1 - BETA))
+    return -1;
+
+  return 0;
+}
+
+/*************************************************
+* Name:        verify_core
+*
+* Description: Checks unpacked signature against message representative mu
+*              given matrix A and t1*2^d in NTT domain. Without expanded
+*              public key, rows of A and t1 are expanded from the bit-packed
+*              key one at a time. Signature must have passed
+*              unpack_and_check_sig.
+*
+* Arguments:   - const uint8_t *c: pointer to challenge seed
+*              - polyvecl *z: pointer to z; overwritten
+*              - const polyveck *h: pointer to hint vector
+*              - const uint8_t *mu: pointer to message representative
+*              - const expanded_pk *epk: pointer to expanded public key
+*                                        or NULL
+*              - const uint8_t *pk: pointer to bit-packed public key; only
+*                                   used if epk is NULL
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+static int verify_core(const uint8_t c[CTILDEBYTES], polyvecl *z, const polyveck *h,
+                       const uint8_t mu[CRHBYTES], const expanded_pk *epk, const uint8_t *pk)
+{
+  unsigned int i;
+  /* polyw1_pack writes additional 14 bytes */
+  ALIGNED_UINT8(K*POLYW1_PACKEDBYTES+14) buf;
+  polyvecl rowbuf[2];
+  polyvecl *exprow = rowbuf;
+  const polyvecl *row;
+  const poly *t1p;
+  poly cp, w1, t1;
+  keccak_state state;
+
+  poly_challenge(&cp, c);
+  poly_ntt(&cp);
+  polyvecl_ntt(z);
+
+  for(i = 0; i < K; i++) {
+    if(epk) {
+      row = &epk->mat[i];
+      t1p = &epk->t1.vec[i];
+    }
+    else {
+      /* Expand matrix row and transform t1*2^d */
+      polyvec_matrix_expand_row(&exprow, rowbuf, pk, i);
+      row = exprow;
+      polyt1_unpack(&t1, pk + SEEDBYTES + i*POLYT1_PACKEDBYTES);
+      poly_shiftl(&t1);
+      poly_ntt(&t1);
+      t1p = &t1;
+    }
+
+    /* Compute i-th row of Az - c2^Dt1 */
+    polyvecl_pointwise_acc_sub_invntt_tomont(&w1, row, z, &cp, t1p);
+
+    /* Reconstruct w1 */
+    poly_caddq(&w1);
+    poly_use_hint(&w1, &w1, &h->vec[i]);
+    polyw1_pack(buf.coeffs + i*POLYW1_PACKEDBYTES, &w1);
+  }
+
+  /* Call random oracle and verify challenge */
+  shake256_init(&state);
+  shake256_absorb(&state, mu, CRHBYTES);
+  shake256_absorb(&state, buf.coeffs, K*POLYW1_PACKEDBYTES);
+  shake256_finalize(&state);
+  shake256_squeeze(buf.coeffs, CTILDEBYTES, &state);
+  for(i = 0; i < CTILDEBYTES; ++i)
+    if(buf.coeffs[i] != c[i])
+      return -1;
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_internal
+*
+* Description: Verifies signature. Internal API.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_internal(const uint8_t *sig, size_t siglen, const uint8_t *m, size_t mlen,
+                                const uint8_t *pre, size_t prelen, const uint8_t *pk) {
+  uint8_t mu[CRHBYTES];
+  uint8_t c[CTILDEBYTES];
+  polyvecl z;
+  polyveck h;
+  keccak_state state;
+
+  if(unpack_and_check_sig(c, &z, &h, sig, siglen))
+    return -1;
+
+  /* Compute CRH(H(rho, t1), pre, msg) */
+  shake256(mu, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+  shake256_init(&state);
+  shake256_absorb(&state, mu, TRBYTES);
+  shake256_absorb(&state, pre, prelen);
+  shake256_absorb(&state, m, mlen);
+  shake256_finalize(&state);
+  shake256_squeeze(mu, CRHBYTES, &state);
+
+  return verify_core(c, &z, &h, mu, NULL, pk);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify
+*
+* Description: Verifies signature.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify(const uint8_t *sig, size_t siglen, const uint8_t *m, size_t mlen,
+                       const uint8_t *ctx, size_t ctxlen, const uint8_t *pk)
+{
+  uint8_t pre[257];
+
+  if(ctxlen > 255)
+    return -1;
+
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  memcpy(&pre[2], ctx, ctxlen);
+#ifdef DILITHIUM_PKCACHE
+  return crypto_sign_verify_cached_internal(sig,siglen,m,mlen,pre,2+ctxlen,pk);
+#else
+  return crypto_sign_verify_internal(sig,siglen,m,mlen,pre,2+ctxlen,pk);
+#endif
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_init
+*
+* Description: Starts incremental verification. The signature is unpacked
+*              and the norm of z and the encoding of the hints are checked
+*              before any message chunk is absorbed, so malformed
+*              signatures are rejected early.
+*
+* Arguments:   - verify_state *state: pointer to output verification state
+*              - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key; must
+*                                   stay valid until crypto_sign_verify_final
+*
+* Returns 0 if verification can proceed and -1 if the signature is invalid
+* or the context string too long; the state must not be used then
+**************************************************/
+int crypto_sign_verify_init(verify_state *state,
+                            const uint8_t *sig, size_t siglen,
+                            const uint8_t *ctx, size_t ctxlen,
+                            const uint8_t *pk)
+{
+  uint8_t pre[2];
+  uint8_t tr[TRBYTES];
+
+  if(ctxlen > 255)
+    return -1;
+
+  if(unpack_and_check_sig(state->c, &state->z, &state->h, sig, siglen))
+    return -1;
+
+  /* Start mu = CRH(H(rho, t1), pre, msg) with pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  state->pk = pk;
+  shake256(tr, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+  shake256_init(&state->mu);
+  shake256_absorb(&state->mu, tr, TRBYTES);
+  shake256_absorb(&state->mu, pre, 2);
+  shake256_absorb(&state->mu, ctx, ctxlen);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_update
+*
+* Description: Absorbs next chunk of the signed message.
+*
+* Arguments:   - verify_state *state: pointer to verification state
+*              - const uint8_t *m: pointer to message chunk
+*              - size_t mlen: length of message chunk
+**************************************************/
+void crypto_sign_verify_update(verify_state *state, const uint8_t *m, size_t mlen) {
+  shake256_absorb(&state->mu, m, mlen);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_final
+*
+* Description: Verifies signature over all absorbed message chunks.
+*
+* Arguments:   - verify_state *state: pointer to verification state
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_final(verify_state *state) {
+  uint8_t mu[CRHBYTES];
+
+  shake256_finalize(&state->mu);
+  shake256_squeeze(mu, CRHBYTES, &state->mu);
+
+  return verify_core(state->c, &state->z, &state->h, mu, NULL, state->pk);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_iov
+*
+* Description: Verifies signature of message given as list of segments.
+*              The segments are absorbed in order without being copied
+*              into one buffer.
+*
+* Arguments:   - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const sign_iovec *iov: pointer to array of message segments
+*              - size_t iovcnt: number of message segments
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_iov(const uint8_t *sig, size_t siglen,
+                           const sign_iovec *iov, size_t iovcnt,
+                           const uint8_t *ctx, size_t ctxlen,
+                           const uint8_t *pk)
+{
+  size_t i;
+  verify_state state;
+
+  if(crypto_sign_verify_init(&state, sig, siglen, ctx, ctxlen, pk))
+    return -1;
+  for(i = 0; i < iovcnt; ++i)
+    crypto_sign_verify_update(&state, iov[i].base, iov[i].len);
+  return crypto_sign_verify_final(&state);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_extmu
+*
+* Description: Verifies signature for externally computed message
+*              representative mu.
+*
+* Arguments:   - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *mu: pointer to message representative
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_extmu(const uint8_t *sig, size_t siglen,
+                             const uint8_t mu[CRHBYTES],
+                             const uint8_t *pk)
+{
+  uint8_t c[CTILDEBYTES];
+  polyvecl z;
+  polyveck h;
+
+  if(unpack_and_check_sig(c, &z, &h, sig, siglen))
+    return -1;
+
+  return verify_core(c, &z, &h, mu, NULL, pk);
+}
+
+/*************************************************
+* Name:        crypto_sign_expand_pk
+*
+* Description: Expands bit-packed public key into verification context
+*              holding tr = H(pk), matrix A and t1*2^d in NTT domain, so that
+*              repeated verification under the same key only performs the
+*              per-signature work.
+*
+* Arguments:   - expanded_pk *epk: pointer to output expanded public key
+*              - uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_expand_pk(expanded_pk *epk, const uint8_t *pk)
+{
+  unsigned int i;
+
+  shake256(epk->tr, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+
+  /* Expand matrix and transform t1*2^d */
+  polyvec_matrix_expand(epk->mat, pk);
+  for(i = 0; i < K; i++) {
+    polyt1_unpack(&epk->t1.vec[i], pk + SEEDBYTES + i*POLYT1_PACKEDBYTES);
+    poly_shiftl(&epk->t1.vec[i]);
+    poly_ntt(&epk->t1.vec[i]);
+  }
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_expanded_internal
+*
+* Description: Verifies signature with expanded public key. Internal API.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - const expanded_pk *epk: pointer to expanded public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_expanded_internal(const uint8_t *sig, size_t siglen, const uint8_t *m, size_t mlen,
+                                         const uint8_t *pre, size_t prelen, const expanded_pk *epk) {
+  uint8_t mu[CRHBYTES];
+  uint8_t c[CTILDEBYTES];
+  polyvecl z;
+  polyveck h;
+  keccak_state state;
+
+  if(unpack_and_check_sig(c, &z, &h, sig, siglen))
+    return -1;
+
+  /* Compute CRH(tr, pre, msg) */
+  shake256_init(&state);
+  shake256_absorb(&state, epk->tr, TRBYTES);
+  shake256_absorb(&state, pre, prelen);
+  shake256_absorb(&state, m, mlen);
+  shake256_finalize(&state);
+  shake256_squeeze(mu, CRHBYTES, &state);
+
+  return verify_core(c, &z, &h, mu, epk, NULL);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_expanded
+*
+* Description: Verifies signature with expanded public key.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const expanded_pk *epk: pointer to expanded public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_expanded(const uint8_t *sig, size_t siglen, const uint8_t *m, size_t mlen,
+                                const uint8_t *ctx, size_t ctxlen, const expanded_pk *epk)
+{
+  uint8_t pre[257];
+
+  if(ctxlen > 255)
+    return -1;
+
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  memcpy(&pre[2], ctx, ctxlen);
+  return crypto_sign_verify_expanded_internal(sig,siglen,m,mlen,pre,2+ctxlen,epk);
+}
+
+/*************************************************
+* Name:        verify_x4
+*
+* Description: Verifies four signatures under four public keys, running
+*              all hashing and matrix expansion 4-way across the items.
+*
+* Arguments:   - int ret[4]: output results (0 if valid, -1 otherwise)
+*              - const uint8_t *sig[4]: signatures of length CRYPTO_BYTES
+*              - const uint8_t *m[4]: messages
+*              - const size_t mlen[4]: lengths of messages
+*              - const uint8_t *pre[4]: prefix strings
+*              - const size_t prelen[4]: lengths of prefix strings
+*              - const uint8_t *pk[4]: bit-packed public keys
+**************************************************/
+static void verify_x4(int ret[4], const uint8_t *sig[4], const uint8_t *m[4], const size_t mlen[4],
+                      const uint8_t *pre[4], const size_t prelen[4], const uint8_t *pk[4])
+{
+  unsigned int i, j, k;
+  int fail[4];
+  /* polyw1_pack writes additional 14 bytes */
+  ALIGNED_UINT8(CRHBYTES+K*POLYW1_PACKEDBYTES+14) buf[4];
+  uint8_t tr[4][TRBYTES];
+  uint8_t mu[4][CRHBYTES];
+  uint8_t seed[4][CTILDEBYTES];
+  uint8_t ctilde[4][CTILDEBYTES];
+  polyvecl row[4], z[4];
+  polyveck h[4];
+  poly c[4], w1, t1;
+
+  /* Unpack and check signatures */
+  for(k = 0; k < 4; ++k)
+    fail[k] = unpack_and_check_sig(seed[k], &z[k], &h[k], sig[k], CRYPTO_BYTES);
+
+  /* Compute CRH(H(rho, t1), pre, msg) */
+  shake256x4(tr[0], tr[1], tr[2], tr[3], TRBYTES, pk[0], pk[1], pk[2], pk[3], CRYPTO_PUBLICKEYBYTES);
+  crh_x4(mu, tr, pre, prelen, m, mlen);
+
+  /* Expand challenges */
+  poly_challenge_4x(&c[0], &c[1], &c[2], &c[3], seed[0], seed[1], seed[2], seed[3]);
+
+  for(k = 0; k < 4; ++k) {
+    poly_ntt(&c[k]);
+    polyvecl_ntt(&z[k]);
+    memcpy(buf[k].coeffs, mu[k], CRHBYTES);
+  }
+
+  for(i = 0; i < K; i++) {
+    /* Expand i-th matrix row of all four keys */
+    for(j = 0; j < L; j++) {
+      poly_uniform_4x_seeds(&row[0].vec[j], &row[1].vec[j], &row[2].vec[j], &row[3].vec[j],
+                            pk[0], pk[1], pk[2], pk[3],
+                            (i << 8) + j, (i << 8) + j, (i << 8) + j, (i << 8) + j);
+      for(k = 0; k < 4; k++)
+        poly_nttunpack(&row[k].vec[j]);
+    }
+
+    for(k = 0; k < 4; k++) {
+      if(fail[k])
+        continue;
+
+      /* Compute i-th row of Az - c2^Dt1 */
+      polyt1_unpack(&t1, pk[k] + SEEDBYTES + i*POLYT1_PACKEDBYTES);
+      poly_shiftl(&t1);
+      poly_ntt(&t1);
+      polyvecl_pointwise_acc_sub_invntt_tomont(&w1, &row[k], &z[k], &c[k], &t1);
+
+      /* Reconstruct w1 */
+      poly_caddq(&w1);
+      poly_use_hint(&w1, &w1, &h[k].vec[i]);
+      polyw1_pack(buf[k].coeffs + CRHBYTES + i*POLYW1_PACKEDBYTES, &w1);
+    }
+  }
+
+  /* Call random oracle and verify challenges */
+  shake256x4(ctilde[0], ctilde[1], ctilde[2], ctilde[3], CTILDEBYTES,
+             buf[0].coeffs, buf[1].coeffs, buf[2].coeffs, buf[3].coeffs, CRHBYTES + K*POLYW1_PACKEDBYTES);
+  for(k = 0; k < 4; k++)
+    ret[k] = (fail[k] || memcmp(ctilde[k], seed[k], CTILDEBYTES)) ? -1 : 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_batch
+*
+* Description: Verifies n independent signatures. Result i equals the
+*              return value of crypto_sign_verify on the i-th tuple.
+*
+* Arguments:   - int *ret: pointer to output array of n results
+*                          (0 if i-th signature is valid, -1 otherwise)
+*              - const uint8_t *const sig[]: array of n signatures
+*              - const size_t siglen[]: array of signature lengths
+*              - const uint8_t *const m[]: array of n messages
+*              - const size_t mlen[]: array of message lengths
+*              - const uint8_t *const ctx[]: array of n context strings
+*              - const size_t ctxlen[]: array of context string lengths
+*              - const uint8_t *const pk[]: array of n bit-packed public keys
+*              - size_t n: number of signatures
+*
+* Returns 0 if all signatures could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_batch(int *ret,
+                             const uint8_t *const sig[], const size_t siglen[],
+                             const uint8_t *const m[], const size_t mlen[],
+                             const uint8_t *const ctx[], const size_t ctxlen[],
+                             const uint8_t *const pk[], size_t n)
+{
+  size_t i, l, cnt, idx[4];
+  unsigned int k;
+  int res = 0, r[4];
+  uint8_t pre[4][257];
+  const uint8_t *sigx[4], *mx[4], *prex[4], *pkx[4];
+  size_t mlenx[4], prelenx[4];
+
+  i = 0;
+  while(i < n) {
+    /* Collect up to four well-formed items */
+    for(cnt = 0; cnt < 4 && i < n; ++i) {
+      if(siglen[i] != CRYPTO_BYTES || ctxlen[i] > 255) {
+        ret[i] = -1;
+        res = -1;
+        continue;
+      }
+      idx[cnt++] = i;
+    }
+    if(cnt == 0)
+      break;
+
+    /* Fill unused lanes with copies of the first item */
+    for(k = 0; k < 4; ++k) {
+      l = (k < cnt) ? idx[k] : idx[0];
+      pre[k][0] = 0;
+      pre[k][1] = ctxlen[l];
+      memcpy(&pre[k][2], ctx[l], ctxlen[l]);
+      sigx[k] = sig[l];
+      mx[k] = m[l];
+      mlenx[k] = mlen[l];
+      prex[k] = pre[k];
+      prelenx[k] = 2 + ctxlen[l];
+      pkx[k] = pk[l];
+    }
+
+    verify_x4(r, sigx, mx, mlenx, prex, prelenx, pkx);
+    for(k = 0; k < cnt; ++k) {
+      ret[idx[k]] = r[k];
+      res |= r[k];
+    }
+  }
+
+  return res;
+}
+
+/*************************************************
+* Name:        crypto_sign_open_inplace
+*
+* Description: Verify signed message without copying the message.
+*
+* Arguments:   - const uint8_t **m: pointer to output pointer to message
+*                                   inside sm; set to NULL on failure
+*              - size_t *mlen: pointer to output length of message
+*              - const uint8_t *sm: pointer to signed message
+*              - size_t smlen: length of signed message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signed message could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_open_inplace(const uint8_t **m, size_t *mlen,
+                             const uint8_t *sm, size_t smlen,
+                             const uint8_t *ctx, size_t ctxlen,
+                             const uint8_t *pk)
+{
+  *m = NULL;
+  *mlen = 0;
+  if(smlen < CRYPTO_BYTES)
+    return -1;
+
+  if(crypto_sign_verify(sm, CRYPTO_BYTES, sm + CRYPTO_BYTES, smlen - CRYPTO_BYTES, ctx, ctxlen, pk))
+    return -1;
+
+  *m = sm + CRYPTO_BYTES;
+  *mlen = smlen - CRYPTO_BYTES;
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_open
 *
 * Description: Verify signed message.
 *
@@ -505,26 +1836,15 @@ int crypto_sign_verify(const uint8_t *sig, size_t siglen, const uint8_t *m, size
 **************************************************/
 int crypto_sign_open(uint8_t *m, size_t *mlen, const uint8_t *sm, size_t smlen,
                      const uint8_t *ctx, size_t ctxlen, const uint8_t *pk) {
-  size_t i;
+  const uint8_t *msg;
 
-  if(smlen < CRYPTO_BYTES)
-    goto badsig;
-
-  *mlen = smlen - CRYPTO_BYTES;
-  if(crypto_sign_verify(sm, CRYPTO_BYTES, sm + CRYPTO_BYTES, *mlen, ctx, ctxlen, pk))
-    goto badsig;
-  else {
-    /* All good, copy msg, return 0 */
-    for(i = 0; i < *mlen; ++i)
-      m[i] = sm[CRYPTO_BYTES + i];
-    return 0;
+  if(crypto_sign_open_inplace(&msg, mlen, sm, smlen, ctx, ctxlen, pk)) {
+    /* Signature verification failed */
+    memset(m, 0, smlen);
+    return -1;
   }
 
-badsig:
-  /* Signature verification failed */
-  *mlen = 0;
-  for(i = 0; i < smlen; ++i)
-    m[i] = 0;
-
-  return -1;
+  /* All good, move msg, return 0 */
+  memmove(m, msg, *mlen);
+  return 0;
 }
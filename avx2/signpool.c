@@ -0,0 +1 @@
+../ref/signpool.c
\ No newline at end of file
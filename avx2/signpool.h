@@ -0,0 +1 @@
+../ref/signpool.h
\ No newline at end of file
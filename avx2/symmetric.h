@@ -23,4 +23,7 @@ void dilithium_shake256_stream_init(keccak_state *state, const uint8_t seed[CRHB
 #define stream256_init(STATE, SEED, NONCE) dilithium_shake256_stream_init(STATE, SEED, NONCE)
 #define stream256_squeezeblocks(OUT, OUTBLOCKS, STATE) shake256_squeezeblocks(OUT, OUTBLOCKS, STATE)
 
+/* 4-way Keccak (fips202x4) is available for multi-message hashing */
+#define DILITHIUM_KECCAKX4
+
 #endif
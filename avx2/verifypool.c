@@ -0,0 +1 @@
+../ref/verifypool.c
\ No newline at end of file
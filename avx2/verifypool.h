@@ -0,0 +1 @@
+../ref/verifypool.h
\ No newline at end of file
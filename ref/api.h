@@ -11,9 +11,15 @@
 #define pqcrystals_dilithium2_ref_PUBLICKEYBYTES pqcrystals_dilithium2_PUBLICKEYBYTES
 #define pqcrystals_dilithium2_ref_SECRETKEYBYTES pqcrystals_dilithium2_SECRETKEYBYTES
 #define pqcrystals_dilithium2_ref_BYTES pqcrystals_dilithium2_BYTES
+#define pqcrystals_dilithium2_ref_SEEDKEYBYTES 32
+
+int pqcrystals_dilithium2_ref_seed_keypair(uint8_t *pk, uint8_t *sk,
+                                           const uint8_t *seed);
 
 int pqcrystals_dilithium2_ref_keypair(uint8_t *pk, uint8_t *sk);
 
+int pqcrystals_dilithium2_ref_seed_expand(uint8_t *sk, const uint8_t *seed);
+
 int pqcrystals_dilithium2_ref_signature(uint8_t *sig, size_t *siglen,
                                         const uint8_t *m, size_t mlen,
                                         const uint8_t *ctx, size_t ctxlen,
@@ -41,9 +47,15 @@ int pqcrystals_dilithium2_ref_open(uint8_t *m, size_t *mlen,
 #define pqcrystals_dilithium3_ref_PUBLICKEYBYTES pqcrystals_dilithium3_PUBLICKEYBYTES
 #define pqcrystals_dilithium3_ref_SECRETKEYBYTES pqcrystals_dilithium3_SECRETKEYBYTES
 #define pqcrystals_dilithium3_ref_BYTES pqcrystals_dilithium3_BYTES
+#define pqcrystals_dilithium3_ref_SEEDKEYBYTES 32
+
+int pqcrystals_dilithium3_ref_seed_keypair(uint8_t *pk, uint8_t *sk,
+                                           const uint8_t *seed);
 
 int pqcrystals_dilithium3_ref_keypair(uint8_t *pk, uint8_t *sk);
 
+int pqcrystals_dilithium3_ref_seed_expand(uint8_t *sk, const uint8_t *seed);
+
 int pqcrystals_dilithium3_ref_signature(uint8_t *sig, size_t *siglen,
                                         const uint8_t *m, size_t mlen,
                                         const uint8_t *ctx, size_t ctxlen,
@@ -71,9 +83,15 @@ int pqcrystals_dilithium3_ref_open(uint8_t *m, size_t *mlen,
 #define pqcrystals_dilithium5_ref_PUBLICKEYBYTES pqcrystals_dilithium5_PUBLICKEYBYTES
 #define pqcrystals_dilithium5_ref_SECRETKEYBYTES pqcrystals_dilithium5_SECRETKEYBYTES
 #define pqcrystals_dilithium5_ref_BYTES pqcrystals_dilithium5_BYTES
+#define pqcrystals_dilithium5_ref_SEEDKEYBYTES 32
+
+int pqcrystals_dilithium5_ref_seed_keypair(uint8_t *pk, uint8_t *sk,
+                                           const uint8_t *seed);
 
 int pqcrystals_dilithium5_ref_keypair(uint8_t *pk, uint8_t *sk);
 
+int pqcrystals_dilithium5_ref_seed_expand(uint8_t *sk, const uint8_t *seed);
+
 int pqcrystals_dilithium5_ref_signature(uint8_t *sig, size_t *siglen,
                                         const uint8_t *m, size_t mlen,
                                         const uint8_t *ctx, size_t ctxlen,
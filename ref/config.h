@@ -3,8 +3,8 @@
 
 //#define DILITHIUM_MODE 2
 #define DILITHIUM_RANDOMIZED_SIGNING
+//#define DILITHIUM_PKCACHE
 //#define USE_RDPMC
-//#define DBENCH
 
 #ifndef DILITHIUM_MODE
 #define DILITHIUM_MODE 2
@@ -0,0 +1,37 @@
+#ifndef DBENCH_H
+#define DBENCH_H
+
+#include <stdint.h>
+
+/* Per-primitive cycle accounting. With DBENCH defined every instrumented
+ * primitive adds its cycles, minus the cost of reading the counter, to one
+ * of the counters below. Only test/speed_print.c defines them, so DBENCH
+ * is a compiler flag for builds that link the speed harness (make dbench)
+ * rather than an option in config.h. The counters are thread-local, so
+ * signing and verification pool workers never race with the caller; only
+ * the calling thread's cycles are reported. */
+
+#ifdef DBENCH
+#include "test/cpucycles.h"
+
+extern uint64_t timing_overhead;
+extern _Thread_local uint64_t dbench_counters[9];
+
+#define tred (&dbench_counters[0])
+#define tadd (&dbench_counters[1])
+#define tmul (&dbench_counters[2])
+#define tntt (&dbench_counters[3])
+#define tinvntt (&dbench_counters[4])
+#define tround (&dbench_counters[5])
+#define tsample (&dbench_counters[6])
+#define tpack (&dbench_counters[7])
+#define tkeccak (&dbench_counters[8])
+
+#define DBENCH_START() uint64_t time = cpucycles()
+#define DBENCH_STOP(t) t += cpucycles() - time - timing_overhead
+#else
+#define DBENCH_START()
+#define DBENCH_STOP(t)
+#endif
+
+#endif
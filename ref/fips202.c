@@ -6,6 +6,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "fips202.h"
+#include "dbench.h"
 
 #define NROUNDS 24
 #define ROL(a, offset) ((a << offset) ^ (a >> (64-offset)))
@@ -95,6 +96,7 @@ static void KeccakF1600_StatePermute(uint64_t state[25])
         uint64_t Eka, Eke, Eki, Eko, Eku;
         uint64_t Ema, Eme, Emi, Emo, Emu;
         uint64_t Esa, Ese, Esi, Eso, Esu;
+        DBENCH_START();
 
         //copyFromState(A, state)
         Aba = state[ 0];
@@ -341,6 +343,8 @@ static void KeccakF1600_StatePermute(uint64_t state[25])
         state[22] = Asi;
         state[23] = Aso;
         state[24] = Asu;
+
+        DBENCH_STOP(*tkeccak);
 }
 
 /*************************************************
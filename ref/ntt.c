@@ -3,63 +3,189 @@
 #include "ntt.h"
 #include "reduce.h"
 
-static const int32_t zetas[N] = {
-         0,    25847, -2608894,  -518909,   237124,  -777960,  -876248,   466468,
-   1826347,  2353451,  -359251, -2091905,  3119733, -2884855,  3111497,  2680103,
-   2725464,  1024112, -1079900,  3585928,  -549488, -1119584,  2619752, -2108549,
-  -2118186, -3859737, -1399561, -3277672,  1757237,   -19422,  4010497,   280005,
-   2706023,    95776,  3077325,  3530437, -1661693, -3592148, -2537516,  3915439,
-  -3861115, -3043716,  3574422, -2867647,  3539968,  -300467,  2348700,  -539299,
-  -1699267, -1643818,  3505694, -3821735,  3507263, -2140649, -1600420,  3699596,
-    811944,   531354,   954230,  3881043,  3900724, -2556880,  2071892, -2797779,
-  -3930395, -1528703, -3677745, -3041255, -1452451,  3475950,  2176455, -1585221,
-  -1257611,  1939314, -4083598, -1000202, -3190144, -3157330, -3632928,   126922,
-   3412210,  -983419,  2147896,  2715295, -2967645, -3693493,  -411027, -2477047,
-   -671102, -1228525,   -22981, -1308169,  -381987,  1349076,  1852771, -1430430,
-  -3343383,   264944,   508951,  3097992,    44288, -1100098,   904516,  3958618,
-  -3724342,    -8578,  1653064, -3249728,  2389356,  -210977,   759969, -1316856,
-    189548, -3553272,  3159746, -1851402, -2409325,  -177440,  1315589,  1341330,
-   1285669, -1584928,  -812732, -1439742, -3019102, -3881060, -3628969,  3839961,
-   2091667,  3407706,  2316500,  3817976, -3342478,  2244091, -2446433, -3562462,
-    266997,  2434439, -1235728,  3513181, -3520352, -3759364, -1197226, -3193378,
-    900702,  1859098,   909542,   819034,   495491, -1613174,   -43260,  -522500,
-   -655327, -3122442,  2031748,  3207046, -3556995,  -525098,  -768622, -3595838,
-    342297,   286988, -2437823,  4108315,  3437287, -3342277,  1735879,   203044,
-   2842341,  2691481, -2590150,  1265009,  4055324,  1247620,  2486353,  1595974,
-  -3767016,  1250494,  2635921, -3548272, -2994039,  1869119,  1903435, -1050970,
-  -1333058,  1237275, -3318210, -1430225,  -451100,  1312455,  3306115, -1962642,
-  -1279661,  1917081, -2546312, -1374803,  1500165,   777191,  2235880,  3406031,
-   -542412, -2831860, -1671176, -1846953, -2584293, -3724270,   594136, -3776993,
-  -2013608,  2432395,  2454455,  -164721,  1957272,  3369112,   185531, -1207385,
-  -3183426,   162844,  1616392,  3014001,   810149,  1652634, -3694233, -1799107,
-  -3038916,  3523897,  3866901,   269760,  2213111,  -975884,  1717735,   472078,
-   -426683,  1723600, -1803090,  1910376, -1667432, -1104333,  -260646, -3833893,
-  -2939036, -2235985,  -420899, -2286327,   183443,  -976891,  1612842, -3545687,
-   -554416,  3919660,   -48306, -1362209,  3937738,  1400424,  -846154,  1976782
+/* The transforms work in three passes: layers 1-3, layers 4-6 and layers
+ * 7-8. Each pass loads a group of eight (or four) coefficients that are
+ * only combined with each other in these layers, runs all its layers on
+ * local variables and stores them again, so every coefficient is loaded and
+ * stored three times instead of eight. The twiddle factors are stored in the
+ * order in which the passes use them. Only the products with twiddle factors
+ * are reduced; sums and differences grow by at most a factor of two per
+ * layer, which the bounds below allow for. */
+
+/* Forward passes */
+static const int32_t zetas[255] = {
+     25847, -2608894,  -518909,   237124,  -777960,  -876248,   466468,  1826347,
+   2725464,  1024112,  2706023,    95776,  3077325,  3530437,  2353451, -1079900,
+   3585928, -1661693, -3592148, -2537516,  3915439,  -359251,  -549488, -1119584,
+  -3861115, -3043716,  3574422, -2867647, -2091905,  2619752, -2108549,  3539968,
+   -300467,  2348700,  -539299,  3119733, -2118186, -3859737, -1699267, -1643818,
+   3505694, -3821735, -2884855, -1399561, -3277672,  3507263, -2140649, -1600420,
+   3699596,  3111497,  1757237,   -19422,   811944,   531354,   954230,  3881043,
+   2680103,  4010497,   280005,  3900724, -2556880,  2071892, -2797779, -3930395,
+   2091667,  3407706, -1528703,  2316500,  3817976, -3677745, -3342478,  2244091,
+  -3041255, -2446433, -3562462, -1452451,   266997,  2434439,  3475950, -1235728,
+   3513181,  2176455, -3520352, -3759364, -1585221, -1197226, -3193378, -1257611,
+    900702,  1859098,  1939314,   909542,   819034, -4083598,   495491, -1613174,
+  -1000202,   -43260,  -522500, -3190144,  -655327, -3122442, -3157330,  2031748,
+   3207046, -3632928, -3556995,  -525098,   126922,  -768622, -3595838,  3412210,
+    342297,   286988,  -983419, -2437823,  4108315,  2147896,  3437287, -3342277,
+   2715295,  1735879,   203044, -2967645,  2842341,  2691481, -3693493, -2590150,
+   1265009,  -411027,  4055324,  1247620, -2477047,  2486353,  1595974,  -671102,
+  -3767016,  1250494, -1228525,  2635921, -3548272,   -22981, -2994039,  1869119,
+  -1308169,  1903435, -1050970,  -381987, -1333058,  1237275,  1349076, -3318210,
+  -1430225,  1852771,  -451100,  1312455, -1430430,  3306115, -1962642, -3343383,
+  -1279661,  1917081,   264944, -2546312, -1374803,   508951,  1500165,   777191,
+   3097992,  2235880,  3406031,    44288,  -542412, -2831860, -1100098, -1671176,
+  -1846953,   904516, -2584293, -3724270,  3958618,   594136, -3776993, -3724342,
+  -2013608,  2432395,    -8578,  2454455,  -164721,  1653064,  1957272,  3369112,
+  -3249728,   185531, -1207385,  2389356, -3183426,   162844,  -210977,  1616392,
+   3014001,   759969,   810149,  1652634, -1316856, -3694233, -1799107,   189548,
+  -3038916,  3523897, -3553272,  3866901,   269760,  3159746,  2213111,  -975884,
+  -1851402,  1717735,   472078, -2409325,  -426683,  1723600,  -177440, -1803090,
+   1910376,  1315589, -1667432, -1104333,  1341330,  -260646, -3833893,  1285669,
+  -2939036, -2235985, -1584928,  -420899, -2286327,  -812732,   183443,  -976891,
+  -1439742,  1612842, -3545687, -3019102,  -554416,  3919660, -3881060,   -48306,
+  -1362209, -3628969,  3937738,  1400424,  3839961,  -846154,  1976782
+};
+
+/* Negated, in the order of the inverse passes */
+static const int32_t zetas_inv[254] = {
+  -1976782,   846154, -3839961, -1400424, -3937738,  3628969,  1362209,    48306,
+   3881060, -3919660,   554416,  3019102,  3545687, -1612842,  1439742,   976891,
+   -183443,   812732,  2286327,   420899,  1584928,  2235985,  2939036, -1285669,
+   3833893,   260646, -1341330,  1104333,  1667432, -1315589, -1910376,  1803090,
+    177440, -1723600,   426683,  2409325,  -472078, -1717735,  1851402,   975884,
+  -2213111, -3159746,  -269760, -3866901,  3553272, -3523897,  3038916,  -189548,
+   1799107,  3694233,  1316856, -1652634,  -810149,  -759969, -3014001, -1616392,
+    210977,  -162844,  3183426, -2389356,  1207385,  -185531,  3249728, -3369112,
+  -1957272, -1653064,   164721, -2454455,     8578, -2432395,  2013608,  3724342,
+   3776993,  -594136, -3958618,  3724270,  2584293,  -904516,  1846953,  1671176,
+   1100098,  2831860,   542412,   -44288, -3406031, -2235880, -3097992,  -777191,
+  -1500165,  -508951,  1374803,  2546312,  -264944, -1917081,  1279661,  3343383,
+   1962642, -3306115,  1430430, -1312455,   451100, -1852771,  1430225,  3318210,
+  -1349076, -1237275,  1333058,   381987,  1050970, -1903435,  1308169, -1869119,
+   2994039,    22981,  3548272, -2635921,  1228525, -1250494,  3767016,   671102,
+  -1595974, -2486353,  2477047, -1247620, -4055324,   411027, -1265009,  2590150,
+   3693493, -2691481, -2842341,  2967645,  -203044, -1735879, -2715295,  3342277,
+  -3437287, -2147896, -4108315,  2437823,   983419,  -286988,  -342297, -3412210,
+   3595838,   768622,  -126922,   525098,  3556995,  3632928, -3207046, -2031748,
+   3157330,  3122442,   655327,  3190144,   522500,    43260,  1000202,  1613174,
+   -495491,  4083598,  -819034,  -909542, -1939314, -1859098,  -900702,  1257611,
+   3193378,  1197226,  1585221,  3759364,  3520352, -2176455, -3513181,  1235728,
+  -3475950, -2434439,  -266997,  1452451,  3562462,  2446433,  3041255, -2244091,
+   3342478,  3677745, -3817976, -2316500,  1528703, -3407706, -2091667,  3930395,
+   2797779, -2071892,  2556880, -3900724,  -280005, -4010497, -2680103, -3881043,
+   -954230,  -531354,  -811944,    19422, -1757237, -3111497, -3699596,  1600420,
+   2140649, -3507263,  3277672,  1399561,  2884855,  3821735, -3505694,  1643818,
+   1699267,  3859737,  2118186, -3119733,   539299, -2348700,   300467, -3539968,
+   2108549, -2619752,  2091905,  2867647, -3574422,  3043716,  3861115,  1119584,
+    549488,   359251, -3915439,  2537516,  3592148,  1661693, -3585928,  1079900,
+  -2353451, -3530437, -3077325,   -95776, -2706023, -1024112, -2725464, -1826347,
+   -466468,   876248,   777960,  -237124,   518909,  2608894
 };
 
+/* mont^2/256 and mont^2/256 * -zetas[1]; the scaling of the inverse
+ * transform is merged into its last layer */
+#define F 41978
+#define FZ 3975713
+
+/* Cooley-Tukey butterfly (a, b) -> (a + zeta*b, a - zeta*b) */
+static inline void ct_butterfly(int32_t *a, int32_t *b, int32_t zeta) {
+  int32_t t;
+
+  t = montgomery_reduce((int64_t)zeta * *b);
+  *b = *a - t;
+  *a = *a + t;
+}
+
+/* Gentleman-Sande butterfly (a, b) -> (a + b, zeta*(a - b)) */
+static inline void gs_butterfly(int32_t *a, int32_t *b, int32_t zeta) {
+  int32_t t;
+
+  t = *a;
+  *a = t + *b;
+  *b = montgomery_reduce((int64_t)zeta * (t - *b));
+}
+
+/* Three forward layers on t[0..7] with strides 4, 2 and 1 */
+static inline void ntt_layers3(int32_t t[8], const int32_t zeta[7]) {
+  ct_butterfly(&t[0], &t[4], zeta[0]);
+  ct_butterfly(&t[1], &t[5], zeta[0]);
+  ct_butterfly(&t[2], &t[6], zeta[0]);
+  ct_butterfly(&t[3], &t[7], zeta[0]);
+
+  ct_butterfly(&t[0], &t[2], zeta[1]);
+  ct_butterfly(&t[1], &t[3], zeta[1]);
+  ct_butterfly(&t[4], &t[6], zeta[2]);
+  ct_butterfly(&t[5], &t[7], zeta[2]);
+
+  ct_butterfly(&t[0], &t[1], zeta[3]);
+  ct_butterfly(&t[2], &t[3], zeta[4]);
+  ct_butterfly(&t[4], &t[5], zeta[5]);
+  ct_butterfly(&t[6], &t[7], zeta[6]);
+}
+
+/* Two inverse layers on t[0..7] with strides 1 and 2 */
+static inline void invntt_layers2(int32_t t[8], const int32_t zeta[6]) {
+  gs_butterfly(&t[0], &t[1], zeta[0]);
+  gs_butterfly(&t[2], &t[3], zeta[1]);
+  gs_butterfly(&t[4], &t[5], zeta[2]);
+  gs_butterfly(&t[6], &t[7], zeta[3]);
+
+  gs_butterfly(&t[0], &t[2], zeta[4]);
+  gs_butterfly(&t[1], &t[3], zeta[4]);
+  gs_butterfly(&t[4], &t[6], zeta[5]);
+  gs_butterfly(&t[5], &t[7], zeta[5]);
+}
+
 /*************************************************
 * Name:        ntt
 *
 * Description: Forward NTT, in-place. No modular reduction is performed after
 *              additions or subtractions. Output vector is in bitreversed order.
+*              Input coefficients need to be smaller than Q in absolute value;
+*              output coefficients are smaller than 9*Q in absolute value.
 *
 * Arguments:   - uint32_t p[N]: input/output coefficient array
 **************************************************/
 void ntt(int32_t a[N]) {
-  unsigned int len, start, j, k;
-  int32_t zeta, t;
-
-  k = 0;
-  for(len = 128; len > 0; len >>= 1) {
-    for(start = 0; start < N; start = j + len) {
-      zeta = zetas[++k];
-      for(j = start; j < start + len; ++j) {
-        t = montgomery_reduce((int64_t)zeta * a[j + len]);
-        a[j + len] = a[j] - t;
-        a[j] = a[j] + t;
-      }
+  unsigned int i, j, k;
+  int32_t t[8];
+  const int32_t *zeta = zetas;
+
+  /* Layers 1-3: coefficients j + 32*i */
+  for(j = 0; j < 32; ++j) {
+    for(i = 0; i < 8; ++i)
+      t[i] = a[j + 32*i];
+    ntt_layers3(t, zeta);
+    for(i = 0; i < 8; ++i)
+      a[j + 32*i] = t[i];
+  }
+  zeta += 7;
+
+  /* Layers 4-6: coefficients 32*k + j + 4*i */
+  for(k = 0; k < 8; ++k) {
+    for(j = 0; j < 4; ++j) {
+      for(i = 0; i < 8; ++i)
+        t[i] = a[32*k + j + 4*i];
+      ntt_layers3(t, zeta);
+      for(i = 0; i < 8; ++i)
+        a[32*k + j + 4*i] = t[i];
     }
+    zeta += 7;
+  }
+
+  /* Layers 7-8: coefficients 4*k + i */
+  for(k = 0; k < 64; ++k) {
+    for(i = 0; i < 4; ++i)
+      t[i] = a[4*k + i];
+    ct_butterfly(&t[0], &t[2], zeta[0]);
+    ct_butterfly(&t[1], &t[3], zeta[0]);
+    ct_butterfly(&t[0], &t[1], zeta[1]);
+    ct_butterfly(&t[2], &t[3], zeta[2]);
+    for(i = 0; i < 4; ++i)
+      a[4*k + i] = t[i];
+    zeta += 3;
   }
 }
 
@@ -75,24 +201,49 @@ void ntt(int32_t a[N]) {
 * Arguments:   - uint32_t p[N]: input/output coefficient array
 **************************************************/
 void invntt_tomont(int32_t a[N]) {
-  unsigned int start, len, j, k;
-  int32_t t, zeta;
-  const int32_t f = 41978; // mont^2/256
-
-  k = 256;
-  for(len = 1; len < N; len <<= 1) {
-    for(start = 0; start < N; start = j + len) {
-      zeta = -zetas[--k];
-      for(j = start; j < start + len; ++j) {
-        t = a[j];
-        a[j] = t + a[j + len];
-        a[j + len] = t - a[j + len];
-        a[j + len] = montgomery_reduce((int64_t)zeta * a[j + len]);
-      }
+  unsigned int i, j, k;
+  int32_t t[8];
+  const int32_t *zeta = zetas_inv;
+
+  /* Layers 8-7: coefficients 4*k + i */
+  for(k = 0; k < 64; ++k) {
+    for(i = 0; i < 4; ++i)
+      t[i] = a[4*k + i];
+    gs_butterfly(&t[0], &t[1], zeta[0]);
+    gs_butterfly(&t[2], &t[3], zeta[1]);
+    gs_butterfly(&t[0], &t[2], zeta[2]);
+    gs_butterfly(&t[1], &t[3], zeta[2]);
+    for(i = 0; i < 4; ++i)
+      a[4*k + i] = t[i];
+    zeta += 3;
+  }
+
+  /* Layers 6-4: coefficients 32*k + j + 4*i */
+  for(k = 0; k < 8; ++k) {
+    for(j = 0; j < 4; ++j) {
+      for(i = 0; i < 8; ++i)
+        t[i] = a[32*k + j + 4*i];
+      invntt_layers2(t, zeta);
+      gs_butterfly(&t[0], &t[4], zeta[6]);
+      gs_butterfly(&t[1], &t[5], zeta[6]);
+      gs_butterfly(&t[2], &t[6], zeta[6]);
+      gs_butterfly(&t[3], &t[7], zeta[6]);
+      for(i = 0; i < 8; ++i)
+        a[32*k + j + 4*i] = t[i];
     }
+    zeta += 7;
   }
 
-  for(j = 0; j < N; ++j) {
-    a[j] = montgomery_reduce((int64_t)f * a[j]);
+  /* Layers 3-1 and scaling: coefficients j + 32*i. The last layer is
+   * unrolled to merge its twiddle factor into the scaling of the upper
+   * half. */
+  for(j = 0; j < 32; ++j) {
+    for(i = 0; i < 8; ++i)
+      t[i] = a[j + 32*i];
+    invntt_layers2(t, zeta);
+    for(i = 0; i < 4; ++i) {
+      a[j + 32*(i + 4)] = montgomery_reduce((int64_t)FZ * (t[i] - t[i + 4]));
+      a[j + 32*i] = montgomery_reduce((int64_t)F * (t[i] + t[i + 4]));
+    }
   }
 }
@@ -0,0 +1,286 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "params.h"
+#include "sign.h"
+#include "pkcache.h"
+#include "fips202.h"
+
+/* Cache of expanded public keys keyed by tr = H(pk).
+ * Entries are reference counted and immutable once published. A reader
+ * holds the lock in shared mode only to find an entry and pin it, and
+ * verifies after releasing the lock. A miss expands the key into a
+ * private entry without holding the lock and then publishes it with a
+ * short exclusive table update. Recency is tracked with a per-entry
+ * reference bit that readers set atomically; the writer evicts with the
+ * CLOCK (second chance) approximation of LRU. An evicted entry is freed
+ * by whoever drops its last reference. */
+
+typedef struct {
+  expanded_pk epk;
+  uint8_t tr[TRBYTES];
+  atomic_uint refs;
+  atomic_uchar ref;
+} pkcache_entry;
+
+static pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+static pkcache_entry **slots;
+static uint32_t *table;
+static size_t nentries, tablemask, hand;
+static int configured;
+static atomic_uint_fast64_t hits, misses, evictions;
+
+static void pin(pkcache_entry *e) {
+  atomic_fetch_add_explicit(&e->refs, 1, memory_order_relaxed);
+}
+
+static void release(pkcache_entry *e) {
+  if(atomic_fetch_sub_explicit(&e->refs, 1, memory_order_acq_rel) == 1)
+    free(e);
+}
+
+static size_t hash_tr(const uint8_t tr[TRBYTES]) {
+  unsigned int i;
+  uint64_t h = 0;
+
+  /* tr is a hash output, so any 8 bytes of it are uniform */
+  for(i = 0; i < 8; ++i)
+    h |= (uint64_t)tr[i] << 8*i;
+
+  return h & tablemask;
+}
+
+static pkcache_entry *lookup(const uint8_t tr[TRBYTES]) {
+  size_t i;
+  pkcache_entry *e;
+
+  if(!nentries)
+    return NULL;
+
+  for(i = hash_tr(tr); table[i]; i = (i + 1) & tablemask) {
+    e = slots[table[i] - 1];
+    if(!memcmp(e->tr, tr, TRBYTES))
+      return e;
+  }
+
+  return NULL;
+}
+
+static void table_insert(size_t slot) {
+  size_t i;
+
+  i = hash_tr(slots[slot]->tr);
+  while(table[i])
+    i = (i + 1) & tablemask;
+  table[i] = slot + 1;
+}
+
+static void table_remove(size_t slot) {
+  size_t i, j, h;
+
+  i = hash_tr(slots[slot]->tr);
+  while(table[i] != slot + 1)
+    i = (i + 1) & tablemask;
+
+  /* Backward-shift deletion keeps probe sequences free of holes */
+  table[i] = 0;
+  for(j = (i + 1) & tablemask; table[j]; j = (j + 1) & tablemask) {
+    h = hash_tr(slots[table[j] - 1]->tr);
+    if(((j - h) & tablemask) >= ((j - i) & tablemask)) {
+      table[i] = table[j];
+      table[j] = 0;
+      i = j;
+    }
+  }
+}
+
+static int resize(size_t bytes) {
+  size_t i, n, tablesize;
+
+  /* Readers still holding a pinned entry keep it alive */
+  for(i = 0; i < nentries; ++i)
+    if(slots[i])
+      release(slots[i]);
+
+  free(slots);
+  free(table);
+  slots = NULL;
+  table = NULL;
+  nentries = tablemask = hand = 0;
+  configured = 1;
+
+  n = bytes / sizeof(pkcache_entry);
+  if(n == 0)
+    return 0;
+  if(n > UINT32_MAX/2)
+    n = UINT32_MAX/2;
+
+  tablesize = 1;
+  while(tablesize < 2*n)
+    tablesize <<= 1;
+
+  slots = calloc(n, sizeof(pkcache_entry *));
+  table = calloc(tablesize, sizeof(uint32_t));
+  if(!slots || !table) {
+    free(slots);
+    free(table);
+    slots = NULL;
+    table = NULL;
+    return -1;
+  }
+
+  nentries = n;
+  tablemask = tablesize - 1;
+  return 0;
+}
+
+static pkcache_entry *insert(const uint8_t tr[TRBYTES], const uint8_t *pk) {
+  size_t slot;
+  pkcache_entry *e, *old;
+
+  e = aligned_alloc(64, (sizeof(pkcache_entry) + 63) & ~(size_t)63);
+  if(!e)
+    return NULL;
+
+  /* Expensive part runs on a private entry without the lock */
+  crypto_sign_expand_pk(&e->epk, pk);
+  memcpy(e->tr, tr, TRBYTES);
+  atomic_init(&e->refs, 1);
+  atomic_init(&e->ref, 1);
+
+  pthread_rwlock_wrlock(&lock);
+  if(!configured)
+    resize(PKCACHE_DEFAULT_BYTES);
+
+  if(!nentries) {
+    pthread_rwlock_unlock(&lock);
+    return e;
+  }
+
+  /* Another thread may have inserted the key in the meantime */
+  old = lookup(tr);
+  if(old) {
+    pin(old);
+    pthread_rwlock_unlock(&lock);
+    free(e);
+    return old;
+  }
+
+  /* Find victim with cleared reference bit */
+  for(;;) {
+    slot = hand;
+    hand = (hand + 1) % nentries;
+    if(!slots[slot] || !atomic_exchange_explicit(&slots[slot]->ref, 0, memory_order_relaxed))
+      break;
+  }
+
+  old = slots[slot];
+  if(old) {
+    table_remove(slot);
+    atomic_fetch_add_explicit(&evictions, 1, memory_order_relaxed);
+  }
+
+  /* One reference for the table, one for the caller */
+  pin(e);
+  slots[slot] = e;
+  table_insert(slot);
+  pthread_rwlock_unlock(&lock);
+
+  if(old)
+    release(old);
+  return e;
+}
+
+/*************************************************
+* Name:        pkcache_set_capacity
+*
+* Description: Sets size of expanded public key cache and drops all
+*              cached keys. A capacity smaller than one entry disables
+*              the cache. Keys still in use by running verifications
+*              are freed when those finish.
+*
+* Arguments:   - size_t bytes: maximum memory used for cached keys
+*
+* Returns 0 (success) or -1 (allocation failed; cache disabled)
+**************************************************/
+int pkcache_set_capacity(size_t bytes) {
+  int ret;
+
+  pthread_rwlock_wrlock(&lock);
+  ret = resize(bytes);
+  pthread_rwlock_unlock(&lock);
+  return ret;
+}
+
+/*************************************************
+* Name:        pkcache_get_stats
+*
+* Description: Reads hit, miss and eviction counters of the cache.
+*
+* Arguments:   - pkcache_stats *stats: pointer to output counters
+**************************************************/
+void pkcache_get_stats(pkcache_stats *stats) {
+  stats->hits = atomic_load_explicit(&hits, memory_order_relaxed);
+  stats->misses = atomic_load_explicit(&misses, memory_order_relaxed);
+  stats->evictions = atomic_load_explicit(&evictions, memory_order_relaxed);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_cached_internal
+*
+* Description: Verifies signature, taking the expanded public key from
+*              the cache and inserting it on a miss. Internal API.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_cached_internal(const uint8_t *sig,
+                                       size_t siglen,
+                                       const uint8_t *m,
+                                       size_t mlen,
+                                       const uint8_t *pre,
+                                       size_t prelen,
+                                       const uint8_t *pk)
+{
+  int ret, enabled;
+  uint8_t tr[TRBYTES];
+  pkcache_entry *e;
+
+  shake256(tr, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+
+  /* Lock is held only for the lookup and the pin */
+  pthread_rwlock_rdlock(&lock);
+  e = lookup(tr);
+  if(e) {
+    pin(e);
+    atomic_store_explicit(&e->ref, 1, memory_order_relaxed);
+  }
+  enabled = nentries || !configured;
+  pthread_rwlock_unlock(&lock);
+
+  if(e) {
+    atomic_fetch_add_explicit(&hits, 1, memory_order_relaxed);
+  } else {
+    atomic_fetch_add_explicit(&misses, 1, memory_order_relaxed);
+    if(enabled)
+      e = insert(tr, pk);
+  }
+
+  /* Cache disabled or out of memory */
+  if(!e)
+    return crypto_sign_verify_internal(sig, siglen, m, mlen, pre, prelen, pk);
+
+  ret = crypto_sign_verify_expanded_internal(sig, siglen, m, mlen, pre, prelen, &e->epk);
+  release(e);
+  return ret;
+}
@@ -0,0 +1,34 @@
+#ifndef PKCACHE_H
+#define PKCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "params.h"
+
+/* Capacity used if pkcache_set_capacity was never called */
+#ifndef PKCACHE_DEFAULT_BYTES
+#define PKCACHE_DEFAULT_BYTES (1 << 22)
+#endif
+
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} pkcache_stats;
+
+#define pkcache_set_capacity DILITHIUM_NAMESPACE(pkcache_set_capacity)
+int pkcache_set_capacity(size_t bytes);
+
+#define pkcache_get_stats DILITHIUM_NAMESPACE(pkcache_get_stats)
+void pkcache_get_stats(pkcache_stats *stats);
+
+#define crypto_sign_verify_cached_internal DILITHIUM_NAMESPACE(verify_cached_internal)
+int crypto_sign_verify_cached_internal(const uint8_t *sig,
+                                       size_t siglen,
+                                       const uint8_t *m,
+                                       size_t mlen,
+                                       const uint8_t *pre,
+                                       size_t prelen,
+                                       const uint8_t *pk);
+
+#endif
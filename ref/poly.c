@@ -5,17 +5,7 @@
 #include "reduce.h"
 #include "rounding.h"
 #include "symmetric.h"
-
-#ifdef DBENCH
-#include "test/cpucycles.h"
-extern const uint64_t timing_overhead;
-extern uint64_t *tred, *tadd, *tmul, *tround, *tsample, *tpack;
-#define DBENCH_START() uint64_t time = cpucycles()
-#define DBENCH_STOP(t) t += cpucycles() - time - timing_overhead
-#else
-#define DBENCH_START()
-#define DBENCH_STOP(t)
-#endif
+#include "dbench.h"
 
 /*************************************************
 * Name:        poly_reduce
@@ -124,7 +114,7 @@ void poly_ntt(poly *a) {
 
   ntt(a->coeffs);
 
-  DBENCH_STOP(*tmul);
+  DBENCH_STOP(*tntt);
 }
 
 /*************************************************
@@ -141,7 +131,7 @@ void poly_invntt_tomont(poly *a) {
 
   invntt_tomont(a->coeffs);
 
-  DBENCH_STOP(*tmul);
+  DBENCH_STOP(*tinvntt);
 }
 
 /*************************************************
@@ -269,27 +259,25 @@ void poly_use_hint(poly *b, const poly *a, const poly *h) {
 int poly_chknorm(const poly *a, int32_t B) {
   unsigned int i;
   int32_t t;
+  unsigned int r = 0;
   DBENCH_START();
 
   if(B > (Q-1)/8)
     return 1;
 
-  /* It is ok to leak which coefficient violates the bound since
-     the probability for each coefficient is independent of secret
-     data but we must not leak the sign of the centralized representative. */
+  /* The loop does not exit early so that it can be vectorized. This leaks
+     nothing about the coefficients, in particular not the sign of the
+     centralized representative. */
   for(i = 0; i < N; ++i) {
     /* Absolute value */
     t = a->coeffs[i] >> 31;
     t = a->coeffs[i] - (t & 2*a->coeffs[i]);
 
-    if(t >= B) {
-      DBENCH_STOP(*tsample);
-      return 1;
-    }
+    r |= (t >= B);
   }
 
   DBENCH_STOP(*tsample);
-  return 0;
+  return r;
 }
 
 /*************************************************
@@ -520,6 +508,69 @@ void poly_challenge(poly *c, const uint8_t seed[CTILDEBYTES]) {
   }
 }
 
+/*************************************************
+* Name:        poly_challenge_sparse
+*
+* Description: Extract positions and signs of the TAU nonzero coefficients
+*              of challenge polynomial. The challenge is public, so the
+*              branches do not leak secret information.
+*
+* Arguments:   - sparse_poly *c: pointer to output sparse polynomial
+*              - const poly *cp: pointer to challenge polynomial
+**************************************************/
+void poly_challenge_sparse(sparse_poly *c, const poly *cp) {
+  unsigned int i, k;
+
+  k = 0;
+  for(i = 0; i < N; ++i) {
+    if(cp->coeffs[i]) {
+      c->pos[k] = i;
+      c->neg[k] = cp->coeffs[i] < 0;
+      ++k;
+    }
+  }
+}
+
+/*************************************************
+* Name:        poly_sparse_mul
+*
+* Description: Multiplication of polynomial by sparse polynomial with
+*              coefficients in {-1,0,1}, as sum of signed negacyclic
+*              rotations. The rotations are read at offsets into a buffer
+*              holding (-a, a, a, -a), so that every term is a plain
+*              addition of N consecutive coefficients. No modular reduction
+*              is performed; output coefficients are bounded by TAU times
+*              the largest input coefficient in absolute value.
+*
+* Arguments:   - poly *r: pointer to output polynomial
+*              - const sparse_poly *c: pointer to sparse polynomial
+*              - const poly *a: pointer to input polynomial
+**************************************************/
+void poly_sparse_mul(poly *r, const sparse_poly *c, const poly *a) {
+  unsigned int i, k;
+  int32_t ext[4*N];
+  const int32_t *p;
+  DBENCH_START();
+
+  for(i = 0; i < N; ++i) {
+    ext[i] = -a->coeffs[i];
+    ext[N + i] = a->coeffs[i];
+    ext[2*N + i] = a->coeffs[i];
+    ext[3*N + i] = -a->coeffs[i];
+  }
+
+  for(i = 0; i < N; ++i)
+    r->coeffs[i] = 0;
+
+  for(k = 0; k < TAU; ++k) {
+    p = &ext[2*N*c->neg[k] + N - c->pos[k]];
+    for(i = 0; i < N; ++i)
+      r->coeffs[i] += p[i];
+  }
+
+  DBENCH_STOP(*tmul);
+}
+
 /*************************************************
 * Name:        polyeta_pack
 *
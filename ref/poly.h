@@ -8,6 +8,13 @@ typedef struct {
   int32_t coeffs[N];
 } poly;
 
+/* Sparse polynomial given by positions and signs of its TAU nonzero
+ * coefficients, all of which are 1 or -1 */
+typedef struct {
+  uint8_t pos[TAU];
+  uint8_t neg[TAU];
+} sparse_poly;
+
 #define poly_reduce DILITHIUM_NAMESPACE(poly_reduce)
 void poly_reduce(poly *a);
 #define poly_caddq DILITHIUM_NAMESPACE(poly_caddq)
@@ -52,6 +59,10 @@ void poly_uniform_gamma1(poly *a,
                          uint16_t nonce);
 #define poly_challenge DILITHIUM_NAMESPACE(poly_challenge)
 void poly_challenge(poly *c, const uint8_t seed[CTILDEBYTES]);
+#define poly_challenge_sparse DILITHIUM_NAMESPACE(poly_challenge_sparse)
+void poly_challenge_sparse(sparse_poly *c, const poly *cp);
+#define poly_sparse_mul DILITHIUM_NAMESPACE(poly_sparse_mul)
+void poly_sparse_mul(poly *r, const sparse_poly *c, const poly *a);
 
 #define polyeta_pack DILITHIUM_NAMESPACE(polyeta_pack)
 void polyeta_pack(uint8_t *r, const poly *a);
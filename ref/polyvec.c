@@ -99,6 +99,24 @@ void polyvecl_pointwise_poly_montgomery(polyvecl *r, const poly *a, const polyve
     poly_pointwise_montgomery(&r->vec[i], a, &v->vec[i]);
 }
 
+/*************************************************
+* Name:        polyvecl_sparse_mul
+*
+* Description: Multiply vector of polynomials of length L by sparse
+*              polynomial with coefficients in {-1,0,1}. Inputs and outputs
+*              are in normal domain; no modular reduction is performed.
+*
+* Arguments:   - polyvecl *r: pointer to output vector
+*              - const sparse_poly *c: pointer to sparse polynomial
+*              - const polyvecl *v: pointer to input vector
+**************************************************/
+void polyvecl_sparse_mul(polyvecl *r, const sparse_poly *c, const polyvecl *v) {
+  unsigned int i;
+
+  for(i = 0; i < L; ++i)
+    poly_sparse_mul(&r->vec[i], c, &v->vec[i]);
+}
+
 /*************************************************
 * Name:        polyvecl_pointwise_acc_montgomery
 *
@@ -275,6 +293,24 @@ void polyveck_pointwise_poly_montgomery(polyveck *r, const poly *a, const polyve
     poly_pointwise_montgomery(&r->vec[i], a, &v->vec[i]);
 }
 
+/*************************************************
+* Name:        polyveck_sparse_mul
+*
+* Description: Multiply vector of polynomials of length K by sparse
+*              polynomial with coefficients in {-1,0,1}. Inputs and outputs
+*              are in normal domain; no modular reduction is performed.
+*
+* Arguments:   - polyveck *r: pointer to output vector
+*              - const sparse_poly *c: pointer to sparse polynomial
+*              - const polyveck *v: pointer to input vector
+**************************************************/
+void polyveck_sparse_mul(polyveck *r, const sparse_poly *c, const polyveck *v) {
+  unsigned int i;
+
+  for(i = 0; i < K; ++i)
+    poly_sparse_mul(&r->vec[i], c, &v->vec[i]);
+}
+
 
 /*************************************************
 * Name:        polyveck_chknorm
@@ -28,6 +28,8 @@ void polyvecl_ntt(polyvecl *v);
 void polyvecl_invntt_tomont(polyvecl *v);
 #define polyvecl_pointwise_poly_montgomery DILITHIUM_NAMESPACE(polyvecl_pointwise_poly_montgomery)
 void polyvecl_pointwise_poly_montgomery(polyvecl *r, const poly *a, const polyvecl *v);
+#define polyvecl_sparse_mul DILITHIUM_NAMESPACE(polyvecl_sparse_mul)
+void polyvecl_sparse_mul(polyvecl *r, const sparse_poly *c, const polyvecl *v);
 #define polyvecl_pointwise_acc_montgomery \
         DILITHIUM_NAMESPACE(polyvecl_pointwise_acc_montgomery)
 void polyvecl_pointwise_acc_montgomery(poly *w,
@@ -66,6 +68,8 @@ void polyveck_ntt(polyveck *v);
 void polyveck_invntt_tomont(polyveck *v);
 #define polyveck_pointwise_poly_montgomery DILITHIUM_NAMESPACE(polyveck_pointwise_poly_montgomery)
 void polyveck_pointwise_poly_montgomery(polyveck *r, const poly *a, const polyveck *v);
+#define polyveck_sparse_mul DILITHIUM_NAMESPACE(polyveck_sparse_mul)
+void polyveck_sparse_mul(polyveck *r, const sparse_poly *c, const polyveck *v);
 
 #define polyveck_chknorm DILITHIUM_NAMESPACE(polyveck_chknorm)
 int polyveck_chknorm(const polyveck *v, int32_t B);
@@ -0,0 +1,198 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "params.h"
+#include "sign.h"
+#include "pkcache.h"
+#include "prehash.h"
+#include "randombytes.h"
+#include "fips202.h"
+#include "symmetric.h"
+#ifdef DILITHIUM_KECCAKX4
+#include "fips202x4.h"
+#endif
+
+/* Pre-hash signing (HashML-DSA) signs the digest of the message with the
+ * prefix pre = (1, ctxlen, ctx, OID) instead of the pure mode prefix
+ * (0, ctxlen, ctx), so both modes never produce the same mu. The digests
+ * are taken from fips202; SHA-512 is not part of this code base, so its
+ * digest has to be computed by the caller. */
+
+#define OIDBYTES 11
+
+static const uint8_t oids[3][OIDBYTES] = {
+  {0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03},
+  {0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x08},
+  {0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x0B}
+};
+
+static const size_t digestbytes[3] = {64, 32, 32};
+
+static size_t prepare_pre(uint8_t pre[2 + 255 + OIDBYTES], unsigned int alg,
+                          const uint8_t *ctx, size_t ctxlen)
+{
+  pre[0] = 1;
+  pre[1] = ctxlen;
+  memcpy(&pre[2], ctx, ctxlen);
+  memcpy(&pre[2 + ctxlen], oids[alg], OIDBYTES);
+  return 2 + ctxlen + OIDBYTES;
+}
+
+/*************************************************
+* Name:        crypto_sign_prehash
+*
+* Description: Computes digest of message for pre-hash signing.
+*
+* Arguments:   - uint8_t *ph: pointer to output digest (of length
+*                             PREHASH_MAXBYTES)
+*              - size_t *phlen: pointer to output length of digest
+*              - unsigned int alg: PREHASH_SHA3_256 or PREHASH_SHAKE128
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*
+* Returns 0 (success) or -1 (digest not available)
+**************************************************/
+int crypto_sign_prehash(uint8_t *ph, size_t *phlen, unsigned int alg,
+                        const uint8_t *m, size_t mlen)
+{
+  switch(alg) {
+    case PREHASH_SHA3_256:
+      sha3_256(ph, m, mlen);
+      break;
+    case PREHASH_SHAKE128:
+      shake128(ph, 32, m, mlen);
+      break;
+    default:
+      return -1;
+  }
+
+  *phlen = digestbytes[alg];
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_prehash_x4
+*
+* Description: Computes digests of four messages of possibly different
+*              lengths for pre-hash signing. Uses the 4-way Keccak
+*              implementation where the build has one and hashes the
+*              messages one after another otherwise.
+*
+* Arguments:   - uint8_t *ph[4]: pointers to output digests (of length
+*                                PREHASH_MAXBYTES)
+*              - size_t *phlen: pointer to output length of digests
+*              - unsigned int alg: PREHASH_SHA3_256 or PREHASH_SHAKE128
+*              - const uint8_t *const m[4]: messages
+*              - const size_t mlen[4]: lengths of messages
+*
+* Returns 0 (success) or -1 (digest not available)
+**************************************************/
+int crypto_sign_prehash_x4(uint8_t *ph[4], size_t *phlen, unsigned int alg,
+                           const uint8_t *const m[4], const size_t mlen[4])
+{
+#ifdef DILITHIUM_KECCAKX4
+  const size_t outlen[4] = {32, 32, 32, 32};
+  keccakx4_state state;
+
+  switch(alg) {
+    case PREHASH_SHA3_256:
+      sha3_256x4(ph, m, mlen);
+      break;
+    case PREHASH_SHAKE128:
+      shake128x4_init(&state);
+      shake128x4_absorb(&state, m, mlen);
+      shake128x4_finalize(&state);
+      shake128x4_squeeze(ph, outlen, &state);
+      break;
+    default:
+      return -1;
+  }
+
+  *phlen = digestbytes[alg];
+#else
+  unsigned int k;
+
+  for(k = 0; k < 4; ++k)
+    if(crypto_sign_prehash(ph[k], phlen, alg, m[k], mlen[k]))
+      return -1;
+#endif
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_prehash
+*
+* Description: Computes pre-hash signature of message digest.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - const uint8_t *ph: pointer to message digest
+*              - size_t phlen: length of message digest
+*              - unsigned int alg: digest used for ph
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success) or -1 (context string too long or wrong digest length)
+**************************************************/
+int crypto_sign_signature_prehash(uint8_t *sig, size_t *siglen,
+                                  const uint8_t *ph, size_t phlen,
+                                  unsigned int alg,
+                                  const uint8_t *ctx, size_t ctxlen,
+                                  const uint8_t *sk)
+{
+  size_t prelen;
+  uint8_t pre[2 + 255 + OIDBYTES];
+  uint8_t rnd[RNDBYTES];
+
+  if(ctxlen > 255 || alg > PREHASH_SHAKE128 || phlen != digestbytes[alg])
+    return -1;
+
+  prelen = prepare_pre(pre, alg, ctx, ctxlen);
+
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+  randombytes(rnd, RNDBYTES);
+#else
+  memset(rnd, 0, RNDBYTES);
+#endif
+
+  return crypto_sign_signature_internal(sig, siglen, ph, phlen, pre, prelen, rnd, sk);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_prehash
+*
+* Description: Verifies pre-hash signature of message digest.
+*
+* Arguments:   - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *ph: pointer to message digest
+*              - size_t phlen: length of message digest
+*              - unsigned int alg: digest used for ph
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_prehash(const uint8_t *sig, size_t siglen,
+                               const uint8_t *ph, size_t phlen,
+                               unsigned int alg,
+                               const uint8_t *ctx, size_t ctxlen,
+                               const uint8_t *pk)
+{
+  size_t prelen;
+  uint8_t pre[2 + 255 + OIDBYTES];
+
+  if(ctxlen > 255 || alg > PREHASH_SHAKE128 || phlen != digestbytes[alg])
+    return -1;
+
+  prelen = prepare_pre(pre, alg, ctx, ctxlen);
+
+#ifdef DILITHIUM_PKCACHE
+  return crypto_sign_verify_cached_internal(sig, siglen, ph, phlen, pre, prelen, pk);
+#else
+  return crypto_sign_verify_internal(sig, siglen, ph, phlen, pre, prelen, pk);
+#endif
+}
@@ -0,0 +1,38 @@
+#ifndef PREHASH_H
+#define PREHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "params.h"
+
+/* Digests for pre-hash (HashML-DSA) signing */
+#define PREHASH_SHA512 0
+#define PREHASH_SHA3_256 1
+#define PREHASH_SHAKE128 2
+
+/* Largest digest length of all supported digests */
+#define PREHASH_MAXBYTES 64
+
+#define crypto_sign_prehash DILITHIUM_NAMESPACE(prehash)
+int crypto_sign_prehash(uint8_t *ph, size_t *phlen, unsigned int alg,
+                        const uint8_t *m, size_t mlen);
+
+#define crypto_sign_prehash_x4 DILITHIUM_NAMESPACE(prehash_x4)
+int crypto_sign_prehash_x4(uint8_t *ph[4], size_t *phlen, unsigned int alg,
+                           const uint8_t *const m[4], const size_t mlen[4]);
+
+#define crypto_sign_signature_prehash DILITHIUM_NAMESPACE(signature_prehash)
+int crypto_sign_signature_prehash(uint8_t *sig, size_t *siglen,
+                                  const uint8_t *ph, size_t phlen,
+                                  unsigned int alg,
+                                  const uint8_t *ctx, size_t ctxlen,
+                                  const uint8_t *sk);
+
+#define crypto_sign_verify_prehash DILITHIUM_NAMESPACE(verify_prehash)
+int crypto_sign_verify_prehash(const uint8_t *sig, size_t siglen,
+                               const uint8_t *ph, size_t phlen,
+                               unsigned int alg,
+                               const uint8_t *ctx, size_t ctxlen,
+                               const uint8_t *pk);
+
+#endif
@@ -1,6 +1,8 @@
 #include <stdint.h>
+#include <string.h>
 #include "params.h"
 #include "sign.h"
+#include "pkcache.h"
 #include "packing.h"
 #include "polyvec.h"
 #include "poly.h"
@@ -9,18 +11,21 @@
 #include "fips202.h"
 
 /*************************************************
-* Name:        crypto_sign_keypair
+* Name:        crypto_sign_seed_keypair
 *
-* Description: Generates public and private key.
+* Description: Deterministically generates public and private key from seed.
 *
 * Arguments:   - uint8_t *pk: pointer to output public key (allocated
 *                             array of CRYPTO_PUBLICKEYBYTES bytes)
 *              - uint8_t *sk: pointer to output private key (allocated
 *                             array of CRYPTO_SECRETKEYBYTES bytes)
+*              - const uint8_t *seed: pointer to input seed (of length
+*                                     CRYPTO_SEEDKEYBYTES)
 *
 * Returns 0 (success)
 **************************************************/
-int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
+int crypto_sign_seed_keypair(uint8_t *pk, uint8_t *sk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]) {
+  unsigned int i;
   uint8_t seedbuf[2*SEEDBYTES + CRHBYTES];
   uint8_t tr[TRBYTES];
   const uint8_t *rho, *rhoprime, *key;
@@ -28,8 +33,9 @@ int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
   polyvecl s1, s1hat;
   polyveck s2, t1, t0;
 
-  /* Get randomness for rho, rhoprime and key */
-  randombytes(seedbuf, SEEDBYTES);
+  /* Expand seed to rho, rhoprime and key */
+  for(i = 0; i < SEEDBYTES; ++i)
+    seedbuf[i] = seed[i];
   seedbuf[SEEDBYTES+0] = K;
   seedbuf[SEEDBYTES+1] = L;
   shake256(seedbuf, 2*SEEDBYTES + CRHBYTES, seedbuf, SEEDBYTES+2);
@@ -67,76 +73,208 @@ int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
 }
 
 /*************************************************
-* Name:        crypto_sign_signature_internal
+* Name:        crypto_sign_keypair
 *
-* Description: Computes signature. Internal API.
+* Description: Generates public and private key.
 *
-* Arguments:   - uint8_t *sig:   pointer to output signature (of length CRYPTO_BYTES)
-*              - size_t *siglen: pointer to output length of signature
-*              - uint8_t *m:     pointer to message to be signed
-*              - size_t mlen:    length of message
-*              - uint8_t *pre:   pointer to prefix string
-*              - size_t prelen:  length of prefix string
-*              - uint8_t *rnd:   pointer to random seed
-*              - uint8_t *sk:    pointer to bit-packed secret key
+* Arguments:   - uint8_t *pk: pointer to output public key (allocated
+*                             array of CRYPTO_PUBLICKEYBYTES bytes)
+*              - uint8_t *sk: pointer to output private key (allocated
+*                             array of CRYPTO_SECRETKEYBYTES bytes)
 *
 * Returns 0 (success)
 **************************************************/
-int crypto_sign_signature_internal(uint8_t *sig,
-                                   size_t *siglen,
-                                   const uint8_t *m,
-                                   size_t mlen,
-                                   const uint8_t *pre,
-                                   size_t prelen,
-                                   const uint8_t rnd[RNDBYTES],
-                                   const uint8_t *sk)
-{
-  unsigned int n;
-  uint8_t seedbuf[2*SEEDBYTES + TRBYTES + 2*CRHBYTES];
-  uint8_t *rho, *tr, *key, *mu, *rhoprime;
-  uint16_t nonce = 0;
-  polyvecl mat[K], s1, y, z;
-  polyveck t0, s2, w1, w0, h;
-  poly cp;
-  keccak_state state;
+int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
+  uint8_t seed[CRYPTO_SEEDKEYBYTES];
+
+  randombytes(seed, CRYPTO_SEEDKEYBYTES);
+  return crypto_sign_seed_keypair(pk, sk, seed);
+}
+
+/*************************************************
+* Name:        crypto_sign_seed_keypair_x4
+*
+* Description: Deterministically generates four key pairs from four seeds.
+*              Equivalent to four calls of crypto_sign_seed_keypair.
+*
+* Arguments:   - uint8_t *pk[4]: pointers to output public keys (allocated
+*                                arrays of CRYPTO_PUBLICKEYBYTES bytes)
+*              - uint8_t *sk[4]: pointers to output private keys (allocated
+*                                arrays of CRYPTO_SECRETKEYBYTES bytes)
+*              - const uint8_t *seed[4]: pointers to input seeds (of length
+*                                        CRYPTO_SEEDKEYBYTES)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_seed_keypair_x4(uint8_t *pk[4], uint8_t *sk[4], const uint8_t *seed[4]) {
+  unsigned int i;
+
+  for(i = 0; i < 4; ++i)
+    crypto_sign_seed_keypair(pk[i], sk[i], seed[i]);
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_keypair_x4
+*
+* Description: Generates four independent key pairs.
+*
+* Arguments:   - uint8_t *pk[4]: pointers to output public keys (allocated
+*                                arrays of CRYPTO_PUBLICKEYBYTES bytes)
+*              - uint8_t *sk[4]: pointers to output private keys (allocated
+*                                arrays of CRYPTO_SECRETKEYBYTES bytes)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_keypair_x4(uint8_t *pk[4], uint8_t *sk[4]) {
+  unsigned int i;
+  uint8_t seedbuf[4][CRYPTO_SEEDKEYBYTES];
+  const uint8_t *seed[4];
+
+  randombytes(seedbuf[0], 4*CRYPTO_SEEDKEYBYTES);
+  for(i = 0; i < 4; ++i)
+    seed[i] = seedbuf[i];
+
+  return crypto_sign_seed_keypair_x4(pk, sk, seed);
+}
+
+/*************************************************
+* Name:        crypto_sign_seed_expand
+*
+* Description: Expands seed-only secret key to bit-packed secret key.
+*
+* Arguments:   - uint8_t *sk: pointer to output private key (allocated
+*                             array of CRYPTO_SECRETKEYBYTES bytes)
+*              - const uint8_t *seed: pointer to seed-only secret key
+*                                     (of length CRYPTO_SEEDKEYBYTES)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_seed_expand(uint8_t *sk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]) {
+  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
+
+  return crypto_sign_seed_keypair(pk, sk, seed);
+}
+
+/*************************************************
+* Name:        crypto_sign_seed_expand_sk
+*
+* Description: Expands seed-only secret key directly into signing context,
+*              without packing and unpacking a full secret key. Result is
+*              identical to crypto_sign_expand_sk on the key generated by
+*              crypto_sign_seed_keypair from the same seed.
+*
+* Arguments:   - expanded_sk *esk: pointer to output expanded secret key
+*              - const uint8_t *seed: pointer to seed-only secret key
+*                                     (of length CRYPTO_SEEDKEYBYTES)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_seed_expand_sk(expanded_sk *esk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]) {
+  unsigned int i;
+  uint8_t seedbuf[2*SEEDBYTES + CRHBYTES];
+  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
+  const uint8_t *rho, *rhoprime, *key;
+  polyvecl s1hat;
+  polyveck t1;
 
+  /* Expand seed to rho, rhoprime and key */
+  for(i = 0; i < SEEDBYTES; ++i)
+    seedbuf[i] = seed[i];
+  seedbuf[SEEDBYTES+0] = K;
+  seedbuf[SEEDBYTES+1] = L;
+  shake256(seedbuf, 2*SEEDBYTES + CRHBYTES, seedbuf, SEEDBYTES+2);
   rho = seedbuf;
-  tr = rho + SEEDBYTES;
-  key = tr + TRBYTES;
-  mu = key + SEEDBYTES;
-  rhoprime = mu + CRHBYTES;
-  unpack_sk(rho, tr, key, &t0, &s1, &s2, sk);
+  rhoprime = rho + SEEDBYTES;
+  key = rhoprime + CRHBYTES;
+  for(i = 0; i < SEEDBYTES; ++i)
+    esk->key[i] = key[i];
 
-  /* Compute mu = CRH(tr, pre, msg) */
-  shake256_init(&state);
-  shake256_absorb(&state, tr, TRBYTES);
-  shake256_absorb(&state, pre, prelen);
-  shake256_absorb(&state, m, mlen);
-  shake256_finalize(&state);
-  shake256_squeeze(mu, CRHBYTES, &state);
+  /* Expand matrix and sample short vectors s1 and s2 */
+  polyvec_matrix_expand(esk->mat, rho);
+  polyvecl_uniform_eta(&esk->s1, rhoprime, 0);
+  polyveck_uniform_eta(&esk->s2, rhoprime, L);
 
-  /* Compute rhoprime = CRH(key, rnd, mu) */
-  shake256_init(&state);
-  shake256_absorb(&state, key, SEEDBYTES);
-  shake256_absorb(&state, rnd, RNDBYTES);
-  shake256_absorb(&state, mu, CRHBYTES);
-  shake256_finalize(&state);
-  shake256_squeeze(rhoprime, CRHBYTES, &state);
+  /* Matrix-vector multiplication */
+  s1hat = esk->s1;
+  polyvecl_ntt(&s1hat);
+  polyvec_matrix_pointwise_montgomery(&t1, esk->mat, &s1hat);
+  polyveck_reduce(&t1);
+  polyveck_invntt_tomont(&t1);
 
-  /* Expand matrix and transform vectors */
-  polyvec_matrix_expand(mat, rho);
-  polyvecl_ntt(&s1);
-  polyveck_ntt(&s2);
-  polyveck_ntt(&t0);
+  /* Add error vector s2 */
+  polyveck_add(&t1, &t1, &esk->s2);
+
+  /* Extract t1 and compute H(rho, t1) */
+  polyveck_caddq(&t1);
+  polyveck_power2round(&t1, &esk->t0, &t1);
+  pack_pk(pk, rho, &t1);
+  shake256(esk->tr, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_expand_sk
+*
+* Description: Expands bit-packed secret key into signing context holding
+*              matrix A in NTT domain and vectors s1, s2, t0, so that
+*              repeated signing under the same key can skip unpacking and
+*              matrix expansion.
+*
+* Arguments:   - expanded_sk *esk: pointer to output expanded secret key
+*              - uint8_t *sk:      pointer to bit-packed secret key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_expand_sk(expanded_sk *esk, const uint8_t *sk)
+{
+  uint8_t rho[SEEDBYTES];
+
+  unpack_sk(rho, esk->tr, esk->key, &esk->t0, &esk->s1, &esk->s2, sk);
+
+  /* Expand matrix */
+  polyvec_matrix_expand(esk->mat, rho);
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_attempt
+*
+* Description: Runs one iteration of the rejection loop of signing.
+*              Internal API.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - const uint8_t mu[]: message representative (of length CRHBYTES)
+*              - const uint8_t rhoprime[]: seed of masking vector
+*                                          (of length CRHBYTES)
+*              - uint16_t nonce: number of the attempt, starting from 0
+*              - const expanded_sk *esk: pointer to expanded secret key
+*
+* Returns 0 if the signature was accepted and -1 if it was rejected
+**************************************************/
+int crypto_sign_signature_attempt(uint8_t sig[CRYPTO_BYTES],
+                                  const uint8_t mu[CRHBYTES],
+                                  const uint8_t rhoprime[CRHBYTES],
+                                  uint16_t nonce,
+                                  const expanded_sk *esk)
+{
+  unsigned int n;
+  polyvecl y, z;
+  polyveck w1, w0, h;
+  poly cp;
+  sparse_poly c;
+  keccak_state state;
 
-rej:
   /* Sample intermediate vector y */
-  polyvecl_uniform_gamma1(&y, rhoprime, nonce++);
+  polyvecl_uniform_gamma1(&y, rhoprime, nonce);
 
   /* Matrix-vector multiplication */
   z = y;
   polyvecl_ntt(&z);
-  polyvec_matrix_pointwise_montgomery(&w1, mat, &z);
+  polyvec_matrix_pointwise_montgomery(&w1, esk->mat, &z);
   polyveck_reduce(&w1);
   polyveck_invntt_tomont(&w1);
 
@@ -151,43 +289,142 @@ rej:
   shake256_finalize(&state);
   shake256_squeeze(sig, CTILDEBYTES, &state);
   poly_challenge(&cp, sig);
-  poly_ntt(&cp);
+  poly_challenge_sparse(&c, &cp);
 
   /* Compute z, reject if it reveals secret */
-  polyvecl_pointwise_poly_montgomery(&z, &cp, &s1);
-  polyvecl_invntt_tomont(&z);
+  polyvecl_sparse_mul(&z, &c, &esk->s1);
   polyvecl_add(&z, &z, &y);
   polyvecl_reduce(&z);
   if(polyvecl_chknorm(&z, GAMMA1 - BETA))
-    goto rej;
+    return -1;
 
   /* Check that subtracting cs2 does not change high bits of w and low bits
    * do not reveal secret information */
-  polyveck_pointwise_poly_montgomery(&h, &cp, &s2);
-  polyveck_invntt_tomont(&h);
+  polyveck_sparse_mul(&h, &c, &esk->s2);
   polyveck_sub(&w0, &w0, &h);
   polyveck_reduce(&w0);
   if(polyveck_chknorm(&w0, GAMMA2 - BETA))
-    goto rej;
+    return -1;
 
   /* Compute hints for w1 */
-  polyveck_pointwise_poly_montgomery(&h, &cp, &t0);
-  polyveck_invntt_tomont(&h);
-  polyveck_reduce(&h);
+  polyveck_sparse_mul(&h, &c, &esk->t0);
   if(polyveck_chknorm(&h, GAMMA2))
-    goto rej;
+    return -1;
 
   polyveck_add(&w0, &w0, &h);
   n = polyveck_make_hint(&h, &w0, &w1);
   if(n > OMEGA)
-    goto rej;
+    return -1;
 
   /* Write signature */
   pack_sig(sig, sig, &z, &h);
+  return 0;
+}
+
+/*************************************************
+* Name:        sign_mu
+*
+* Description: Computes signature for message representative mu by
+*              running the rejection loop from attempt 0.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - const uint8_t *mu: pointer to message representative
+*              - uint8_t *rnd: pointer to random seed
+*              - expanded_sk *esk: pointer to expanded secret key
+**************************************************/
+static void sign_mu(uint8_t sig[CRYPTO_BYTES],
+                    const uint8_t mu[CRHBYTES],
+                    const uint8_t rnd[RNDBYTES],
+                    const expanded_sk *esk)
+{
+  uint8_t rhoprime[CRHBYTES];
+  uint16_t nonce = 0;
+  keccak_state state;
+
+  /* Compute rhoprime = CRH(key, rnd, mu) */
+  shake256_init(&state);
+  shake256_absorb(&state, esk->key, SEEDBYTES);
+  shake256_absorb(&state, rnd, RNDBYTES);
+  shake256_absorb(&state, mu, CRHBYTES);
+  shake256_finalize(&state);
+  shake256_squeeze(rhoprime, CRHBYTES, &state);
+
+  while(crypto_sign_signature_attempt(sig, mu, rhoprime, nonce++, esk));
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_expanded_internal
+*
+* Description: Computes signature from expanded secret key. Internal API.
+*
+* Arguments:   - uint8_t *sig:   pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m:     pointer to message to be signed
+*              - size_t mlen:    length of message
+*              - uint8_t *pre:   pointer to prefix string
+*              - size_t prelen:  length of prefix string
+*              - uint8_t *rnd:   pointer to random seed
+*              - expanded_sk *esk: pointer to expanded secret key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_signature_expanded_internal(uint8_t *sig,
+                                            size_t *siglen,
+                                            const uint8_t *m,
+                                            size_t mlen,
+                                            const uint8_t *pre,
+                                            size_t prelen,
+                                            const uint8_t rnd[RNDBYTES],
+                                            const expanded_sk *esk)
+{
+  uint8_t mu[CRHBYTES];
+  keccak_state state;
+
+  /* Compute mu = CRH(tr, pre, msg) */
+  shake256_init(&state);
+  shake256_absorb(&state, esk->tr, TRBYTES);
+  shake256_absorb(&state, pre, prelen);
+  shake256_absorb(&state, m, mlen);
+  shake256_finalize(&state);
+  shake256_squeeze(mu, CRHBYTES, &state);
+
+  sign_mu(sig, mu, rnd, esk);
+
   *siglen = CRYPTO_BYTES;
   return 0;
 }
 
+/*************************************************
+* Name:        crypto_sign_signature_internal
+*
+* Description: Computes signature. Internal API.
+*
+* Arguments:   - uint8_t *sig:   pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m:     pointer to message to be signed
+*              - size_t mlen:    length of message
+*              - uint8_t *pre:   pointer to prefix string
+*              - size_t prelen:  length of prefix string
+*              - uint8_t *rnd:   pointer to random seed
+*              - uint8_t *sk:    pointer to bit-packed secret key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_signature_internal(uint8_t *sig,
+                                   size_t *siglen,
+                                   const uint8_t *m,
+                                   size_t mlen,
+                                   const uint8_t *pre,
+                                   size_t prelen,
+                                   const uint8_t rnd[RNDBYTES],
+                                   const uint8_t *sk)
+{
+  expanded_sk esk;
+
+  crypto_sign_expand_sk(&esk, sk);
+  return crypto_sign_signature_expanded_internal(sig, siglen, m, mlen, pre, prelen, rnd, &esk);
+}
+
 /*************************************************
 * Name:        crypto_sign_signature
 *
@@ -236,112 +473,439 @@ int crypto_sign_signature(uint8_t *sig,
 }
 
 /*************************************************
-* Name:        crypto_sign
+* Name:        crypto_sign_signature_expanded
 *
-* Description: Compute signed message.
+* Description: Computes signature from expanded secret key. Output is
+*              identical to crypto_sign_signature with the same key.
 *
-* Arguments:   - uint8_t *sm: pointer to output signed message (allocated
-*                             array with CRYPTO_BYTES + mlen bytes),
-*                             can be equal to m
-*              - size_t *smlen: pointer to output length of signed
-*                               message
-*              - const uint8_t *m: pointer to message to be signed
-*              - size_t mlen: length of message
-*              - const uint8_t *ctx: pointer to context string
-*              - size_t ctxlen: length of context string
-*              - const uint8_t *sk: pointer to bit-packed secret key
+* Arguments:   - uint8_t *sig:   pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m:     pointer to message to be signed
+*              - size_t mlen:    length of message
+*              - uint8_t *ctx:   pointer to contex string
+*              - size_t ctxlen:  length of contex string
+*              - expanded_sk *esk: pointer to expanded secret key
 *
 * Returns 0 (success) or -1 (context string too long)
 **************************************************/
-int crypto_sign(uint8_t *sm,
-                size_t *smlen,
-                const uint8_t *m,
-                size_t mlen,
-                const uint8_t *ctx,
-                size_t ctxlen,
-                const uint8_t *sk)
+int crypto_sign_signature_expanded(uint8_t *sig,
+                                   size_t *siglen,
+                                   const uint8_t *m,
+                                   size_t mlen,
+                                   const uint8_t *ctx,
+                                   size_t ctxlen,
+                                   const expanded_sk *esk)
 {
-  int ret;
   size_t i;
+  uint8_t pre[257];
+  uint8_t rnd[RNDBYTES];
 
-  for(i = 0; i < mlen; ++i)
-    sm[CRYPTO_BYTES + mlen - 1 - i] = m[mlen - 1 - i];
-  ret = crypto_sign_signature(sm, smlen, sm + CRYPTO_BYTES, mlen, ctx, ctxlen, sk);
-  *smlen += mlen;
-  return ret;
-}
+  if(ctxlen > 255)
+    return -1;
 
-/*************************************************
-* Name:        crypto_sign_verify_internal
-*
-* Description: Verifies signature. Internal API.
-*
-* Arguments:   - uint8_t *m: pointer to input signature
-*              - size_t siglen: length of signature
-*              - const uint8_t *m: pointer to message
-*              - size_t mlen: length of message
+  /* Prepare pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  for(i = 0; i < ctxlen; i++)
+    pre[2 + i] = ctx[i];
+
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+  randombytes(rnd, RNDBYTES);
+#else
+  for(i=0;i<RNDBYTES;i++)
+    rnd[i] = 0;
+#endif
+
+  crypto_sign_signature_expanded_internal(sig,siglen,m,mlen,pre,2+ctxlen,rnd,esk);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_batch_internal
+*
+* Description: Computes signatures of n messages under one expanded secret
+*              key. Signature i equals the output of
+*              crypto_sign_signature_expanded_internal on message i with
+*              randomness rnd[i]. Internal API.
+*
+* Arguments:   - uint8_t *const sig[]: array of n output signatures
+*                                      (of length CRYPTO_BYTES)
+*              - size_t siglen[]: array of output signature lengths
+*              - const uint8_t *const m[]: array of n messages
+*              - const size_t mlen[]: array of message lengths
 *              - const uint8_t *pre: pointer to prefix string
 *              - size_t prelen: length of prefix string
-*              - const uint8_t *pk: pointer to bit-packed public key
+*              - const uint8_t *const rnd[]: array of n random seeds
+*                                            (of length RNDBYTES)
+*              - const expanded_sk *esk: pointer to expanded secret key
+*              - size_t n: number of messages
 *
-* Returns 0 if signature could be verified correctly and -1 otherwise
+* Returns 0 (success)
 **************************************************/
-int crypto_sign_verify_internal(const uint8_t *sig,
-                                size_t siglen,
-                                const uint8_t *m,
-                                size_t mlen,
-                                const uint8_t *pre,
-                                size_t prelen,
-                                const uint8_t *pk)
+int crypto_sign_signature_batch_internal(uint8_t *const sig[], size_t siglen[],
+                                         const uint8_t *const m[], const size_t mlen[],
+                                         const uint8_t *pre, size_t prelen,
+                                         const uint8_t *const rnd[],
+                                         const expanded_sk *esk, size_t n)
 {
-  unsigned int i;
-  uint8_t buf[K*POLYW1_PACKEDBYTES];
-  uint8_t rho[SEEDBYTES];
-  uint8_t mu[CRHBYTES];
-  uint8_t c[CTILDEBYTES];
-  uint8_t c2[CTILDEBYTES];
-  poly cp;
-  polyvecl mat[K], z;
-  polyveck t1, w1, h;
-  keccak_state state;
+  size_t i;
 
-  if(siglen != CRYPTO_BYTES)
+  for(i = 0; i < n; ++i)
+    crypto_sign_signature_expanded_internal(sig[i], &siglen[i], m[i], mlen[i], pre, prelen, rnd[i], esk);
+
+  return 0;
+}
+
+/* Messages sharing one buffer of fresh randomness in
+ * crypto_sign_signature_batch */
+#define SIGN_BATCH_CHUNK 32
+
+/*************************************************
+* Name:        crypto_sign_signature_batch
+*
+* Description: Computes signatures of n messages under one secret key,
+*              unpacking and expanding the key only once.
+*
+* Arguments:   - uint8_t *const sig[]: array of n output signatures
+*                                      (of length CRYPTO_BYTES)
+*              - size_t siglen[]: array of output signature lengths
+*              - const uint8_t *const m[]: array of n messages
+*              - const size_t mlen[]: array of message lengths
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*              - size_t n: number of messages
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_signature_batch(uint8_t *const sig[], size_t siglen[],
+                                const uint8_t *const m[], const size_t mlen[],
+                                const uint8_t *ctx, size_t ctxlen,
+                                const uint8_t *sk, size_t n)
+{
+  size_t i, j, cnt;
+  uint8_t pre[257];
+  uint8_t rndbuf[SIGN_BATCH_CHUNK][RNDBYTES];
+  const uint8_t *rnd[SIGN_BATCH_CHUNK];
+  expanded_sk esk;
+
+  if(ctxlen > 255)
     return -1;
 
-  unpack_pk(rho, &t1, pk);
-  if(unpack_sig(c, &z, &h, sig))
+  /* Prepare pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  for(i = 0; i < ctxlen; i++)
+    pre[2 + i] = ctx[i];
+
+  crypto_sign_expand_sk(&esk, sk);
+
+  for(i = 0; i < SIGN_BATCH_CHUNK; ++i) {
+    rnd[i] = rndbuf[i];
+    for(j = 0; j < RNDBYTES; ++j)
+      rndbuf[i][j] = 0;
+  }
+
+  for(i = 0; i < n; i += cnt) {
+    cnt = (n - i < SIGN_BATCH_CHUNK) ? n - i : SIGN_BATCH_CHUNK;
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+    randombytes(rndbuf[0], cnt*RNDBYTES);
+#endif
+    crypto_sign_signature_batch_internal(sig + i, siglen + i, m + i, mlen + i, pre, 2 + ctxlen,
+                                         rnd, &esk, cnt);
+  }
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_init
+*
+* Description: Starts incremental signing. The message is passed in
+*              chunks to crypto_sign_update and the signature is computed
+*              by crypto_sign_final. Output is a signature of the
+*              concatenated chunks as computed by crypto_sign_signature.
+*
+* Arguments:   - sign_state *state: pointer to output signing state
+*              - const uint8_t *sk: pointer to bit-packed secret key; must
+*                                   stay valid until crypto_sign_final
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_init(sign_state *state, const uint8_t *sk,
+                     const uint8_t *ctx, size_t ctxlen)
+{
+  uint8_t pre[2];
+
+  if(ctxlen > 255)
     return -1;
-  if(polyvecl_chknorm(&z, GAMMA1 - BETA))
+
+  /* Start mu = CRH(tr, pre, msg) with pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  state->sk = sk;
+  shake256_init(&state->mu);
+  shake256_absorb(&state->mu, sk + 2*SEEDBYTES, TRBYTES);
+  shake256_absorb(&state->mu, pre, 2);
+  shake256_absorb(&state->mu, ctx, ctxlen);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_update
+*
+* Description: Absorbs next chunk of the message to be signed.
+*
+* Arguments:   - sign_state *state: pointer to signing state
+*              - const uint8_t *m: pointer to message chunk
+*              - size_t mlen: length of message chunk
+**************************************************/
+void crypto_sign_update(sign_state *state, const uint8_t *m, size_t mlen) {
+  shake256_absorb(&state->mu, m, mlen);
+}
+
+/*************************************************
+* Name:        crypto_sign_final
+*
+* Description: Computes signature of all absorbed message chunks.
+*
+* Arguments:   - sign_state *state: pointer to signing state
+*              - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_final(sign_state *state, uint8_t *sig, size_t *siglen) {
+  uint8_t mu[CRHBYTES];
+
+  shake256_finalize(&state->mu);
+  shake256_squeeze(mu, CRHBYTES, &state->mu);
+
+  return crypto_sign_signature_extmu(sig, siglen, mu, state->sk);
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_iov
+*
+* Description: Computes signature of message given as list of segments.
+*              The segments are absorbed in order without being copied
+*              into one buffer. Output is a signature of the concatenated
+*              segments as computed by crypto_sign_signature.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - const sign_iovec *iov: pointer to array of message segments
+*              - size_t iovcnt: number of message segments
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_signature_iov(uint8_t *sig, size_t *siglen,
+                              const sign_iovec *iov, size_t iovcnt,
+                              const uint8_t *ctx, size_t ctxlen,
+                              const uint8_t *sk)
+{
+  size_t i;
+  sign_state state;
+
+  if(crypto_sign_init(&state, sk, ctx, ctxlen))
     return -1;
+  for(i = 0; i < iovcnt; ++i)
+    crypto_sign_update(&state, iov[i].base, iov[i].len);
+  return crypto_sign_final(&state, sig, siglen);
+}
 
-  /* Compute CRH(H(rho, t1), pre, msg) */
+/*************************************************
+* Name:        crypto_sign_compute_mu
+*
+* Description: Computes message representative mu = CRH(H(pk), pre, msg)
+*              with pre = (0, ctxlen, ctx) for use with
+*              crypto_sign_signature_extmu and crypto_sign_verify_extmu.
+*
+* Arguments:   - uint8_t *mu: pointer to output message representative
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_compute_mu(uint8_t mu[CRHBYTES],
+                           const uint8_t *m, size_t mlen,
+                           const uint8_t *ctx, size_t ctxlen,
+                           const uint8_t *pk)
+{
+  uint8_t pre[2];
+  keccak_state state;
+
+  if(ctxlen > 255)
+    return -1;
+
+  pre[0] = 0;
+  pre[1] = ctxlen;
   shake256(mu, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
   shake256_init(&state);
   shake256_absorb(&state, mu, TRBYTES);
-  shake256_absorb(&state, pre, prelen);
+  shake256_absorb(&state, pre, 2);
+  shake256_absorb(&state, ctx, ctxlen);
   shake256_absorb(&state, m, mlen);
   shake256_finalize(&state);
   shake256_squeeze(mu, CRHBYTES, &state);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_extmu
+*
+* Description: Computes signature for externally computed message
+*              representative mu.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - const uint8_t *mu: pointer to message representative
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_signature_extmu(uint8_t *sig, size_t *siglen,
+                                const uint8_t mu[CRHBYTES],
+                                const uint8_t *sk)
+{
+  unsigned int i;
+  uint8_t rnd[RNDBYTES];
+  expanded_sk esk;
+
+  for(i = 0; i < RNDBYTES; i++)
+    rnd[i] = 0;
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+  randombytes(rnd, RNDBYTES);
+#endif
+
+  crypto_sign_expand_sk(&esk, sk);
+  sign_mu(sig, mu, rnd, &esk);
+
+  *siglen = CRYPTO_BYTES;
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign
+*
+* Description: Compute signed message.
+*
+* Arguments:   - uint8_t *sm: pointer to output signed message (allocated
+*                             array with CRYPTO_BYTES + mlen bytes),
+*                             can be equal to m
+*              - size_t *smlen: pointer to output length of signed
+*                               message
+*              - const uint8_t *m: pointer to message to be signed
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *sk: pointer to bit-packed secret key
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign(uint8_t *sm,
+                size_t *smlen,
+                const uint8_t *m,
+                size_t mlen,
+                const uint8_t *ctx,
+                size_t ctxlen,
+                const uint8_t *sk)
+{
+  int ret;
+
+  /* Message may already be in place or overlap sm */
+  if(sm + CRYPTO_BYTES != m)
+    memmove(sm + CRYPTO_BYTES, m, mlen);
+  ret = crypto_sign_signature(sm, smlen, sm + CRYPTO_BYTES, mlen, ctx, ctxlen, sk);
+  *smlen += mlen;
+  return ret;
+}
+
+/*************************************************
+* Name:        unpack_and_check_sig
+*
+* Description: Unpacks signature and checks its length, the norm of z and
+*              the encoding of the hints.
+*
+* Arguments:   - uint8_t *c: pointer to output challenge seed
+*              - polyvecl *z: pointer to output vector z
+*              - polyveck *h: pointer to output hint vector h
+*              - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*
+* Returns 0 if signature is well-formed and -1 otherwise
+**************************************************/
+static int unpack_and_check_sig(uint8_t c[CTILDEBYTES],
+                                polyvecl *z,
+                                polyveck *h,
+                                const uint8_t *sig,
+                                size_t siglen)
+{
+  if(siglen != CRYPTO_BYTES)
+    return -1;
+
+  if(unpack_sig(c, z, h, sig))
+    return -1;
+  if(polyvecl_chknorm(z, GAMMA1 - BETA))
+    return -1;
+
+  return 0;
+}
+
+/*************************************************
+* Name:        verify_core
+*
+* Description: Checks unpacked signature against message representative mu
+*              given matrix A and t1*2^d in NTT domain. Signature must have
+*              passed unpack_and_check_sig.
+*
+* Arguments:   - const uint8_t *c: pointer to challenge seed
+*              - polyvecl *z: pointer to z; overwritten
+*              - const polyveck *h: pointer to hint vector
+*              - const uint8_t *mu: pointer to message representative
+*              - const polyvecl mat[K]: expanded matrix
+*              - const polyveck *t1: pointer to t1*2^d in NTT domain
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+static int verify_core(const uint8_t c[CTILDEBYTES],
+                       polyvecl *z,
+                       const polyveck *h,
+                       const uint8_t mu[CRHBYTES],
+                       const polyvecl mat[K],
+                       const polyveck *t1)
+{
+  unsigned int i;
+  uint8_t buf[K*POLYW1_PACKEDBYTES];
+  uint8_t c2[CTILDEBYTES];
+  poly cp;
+  polyveck ct1, w1;
+  keccak_state state;
 
   /* Matrix-vector multiplication; compute Az - c2^dt1 */
   poly_challenge(&cp, c);
-  polyvec_matrix_expand(mat, rho);
 
-  polyvecl_ntt(&z);
-  polyvec_matrix_pointwise_montgomery(&w1, mat, &z);
+  polyvecl_ntt(z);
+  polyvec_matrix_pointwise_montgomery(&w1, mat, z);
 
   poly_ntt(&cp);
-  polyveck_shiftl(&t1);
-  polyveck_ntt(&t1);
-  polyveck_pointwise_poly_montgomery(&t1, &cp, &t1);
+  polyveck_pointwise_poly_montgomery(&ct1, &cp, t1);
 
-  polyveck_sub(&w1, &w1, &t1);
+  polyveck_sub(&w1, &w1, &ct1);
   polyveck_reduce(&w1);
   polyveck_invntt_tomont(&w1);
 
   /* Reconstruct w1 */
   polyveck_caddq(&w1);
-  polyveck_use_hint(&w1, &w1, &h);
+  polyveck_use_hint(&w1, &w1, h);
   polyveck_pack_w1(buf, &w1);
 
   /* Call random oracle and verify challenge */
@@ -357,6 +921,83 @@ int crypto_sign_verify_internal(const uint8_t *sig,
   return 0;
 }
 
+/*************************************************
+* Name:        verify_mu
+*
+* Description: Checks unpacked signature against message representative mu
+*              under bit-packed public key.
+*
+* Arguments:   - const uint8_t *c: pointer to challenge seed
+*              - polyvecl *z: pointer to z; overwritten
+*              - const polyveck *h: pointer to hint vector
+*              - const uint8_t *mu: pointer to message representative
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+static int verify_mu(const uint8_t c[CTILDEBYTES],
+                     polyvecl *z,
+                     const polyveck *h,
+                     const uint8_t mu[CRHBYTES],
+                     const uint8_t *pk)
+{
+  uint8_t rho[SEEDBYTES];
+  polyvecl mat[K];
+  polyveck t1;
+
+  /* Expand matrix and transform t1*2^d */
+  unpack_pk(rho, &t1, pk);
+  polyvec_matrix_expand(mat, rho);
+  polyveck_shiftl(&t1);
+  polyveck_ntt(&t1);
+
+  return verify_core(c, z, h, mu, mat, &t1);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_internal
+*
+* Description: Verifies signature. Internal API.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_internal(const uint8_t *sig,
+                                size_t siglen,
+                                const uint8_t *m,
+                                size_t mlen,
+                                const uint8_t *pre,
+                                size_t prelen,
+                                const uint8_t *pk)
+{
+  uint8_t mu[CRHBYTES];
+  uint8_t c[CTILDEBYTES];
+  polyvecl z;
+  polyveck h;
+  keccak_state state;
+
+  if(unpack_and_check_sig(c, &z, &h, sig, siglen))
+    return -1;
+
+  /* Compute CRH(H(rho, t1), pre, msg) */
+  shake256(mu, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+  shake256_init(&state);
+  shake256_absorb(&state, mu, TRBYTES);
+  shake256_absorb(&state, pre, prelen);
+  shake256_absorb(&state, m, mlen);
+  shake256_finalize(&state);
+  shake256_squeeze(mu, CRHBYTES, &state);
+
+  return verify_mu(c, &z, &h, mu, pk);
+}
+
 /*************************************************
 * Name:        crypto_sign_verify
 *
@@ -391,7 +1032,324 @@ int crypto_sign_verify(const uint8_t *sig,
   for(i = 0; i < ctxlen; i++)
     pre[2 + i] = ctx[i];
 
+#ifdef DILITHIUM_PKCACHE
+  return crypto_sign_verify_cached_internal(sig,siglen,m,mlen,pre,2+ctxlen,pk);
+#else
   return crypto_sign_verify_internal(sig,siglen,m,mlen,pre,2+ctxlen,pk);
+#endif
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_init
+*
+* Description: Starts incremental verification. The signature is unpacked
+*              and the norm of z and the encoding of the hints are checked
+*              before any message chunk is absorbed, so malformed
+*              signatures are rejected early.
+*
+* Arguments:   - verify_state *state: pointer to output verification state
+*              - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key; must
+*                                   stay valid until crypto_sign_verify_final
+*
+* Returns 0 if verification can proceed and -1 if the signature is invalid
+* or the context string too long; the state must not be used then
+**************************************************/
+int crypto_sign_verify_init(verify_state *state,
+                            const uint8_t *sig, size_t siglen,
+                            const uint8_t *ctx, size_t ctxlen,
+                            const uint8_t *pk)
+{
+  uint8_t pre[2];
+  uint8_t tr[TRBYTES];
+
+  if(ctxlen > 255)
+    return -1;
+
+  if(unpack_and_check_sig(state->c, &state->z, &state->h, sig, siglen))
+    return -1;
+
+  /* Start mu = CRH(H(rho, t1), pre, msg) with pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  state->pk = pk;
+  shake256(tr, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+  shake256_init(&state->mu);
+  shake256_absorb(&state->mu, tr, TRBYTES);
+  shake256_absorb(&state->mu, pre, 2);
+  shake256_absorb(&state->mu, ctx, ctxlen);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_update
+*
+* Description: Absorbs next chunk of the signed message.
+*
+* Arguments:   - verify_state *state: pointer to verification state
+*              - const uint8_t *m: pointer to message chunk
+*              - size_t mlen: length of message chunk
+**************************************************/
+void crypto_sign_verify_update(verify_state *state, const uint8_t *m, size_t mlen) {
+  shake256_absorb(&state->mu, m, mlen);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_final
+*
+* Description: Verifies signature over all absorbed message chunks.
+*
+* Arguments:   - verify_state *state: pointer to verification state
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_final(verify_state *state) {
+  uint8_t mu[CRHBYTES];
+
+  shake256_finalize(&state->mu);
+  shake256_squeeze(mu, CRHBYTES, &state->mu);
+
+  return verify_mu(state->c, &state->z, &state->h, mu, state->pk);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_iov
+*
+* Description: Verifies signature of message given as list of segments.
+*              The segments are absorbed in order without being copied
+*              into one buffer.
+*
+* Arguments:   - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const sign_iovec *iov: pointer to array of message segments
+*              - size_t iovcnt: number of message segments
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_iov(const uint8_t *sig, size_t siglen,
+                           const sign_iovec *iov, size_t iovcnt,
+                           const uint8_t *ctx, size_t ctxlen,
+                           const uint8_t *pk)
+{
+  size_t i;
+  verify_state state;
+
+  if(crypto_sign_verify_init(&state, sig, siglen, ctx, ctxlen, pk))
+    return -1;
+  for(i = 0; i < iovcnt; ++i)
+    crypto_sign_verify_update(&state, iov[i].base, iov[i].len);
+  return crypto_sign_verify_final(&state);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_extmu
+*
+* Description: Verifies signature for externally computed message
+*              representative mu.
+*
+* Arguments:   - const uint8_t *sig: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *mu: pointer to message representative
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_extmu(const uint8_t *sig, size_t siglen,
+                             const uint8_t mu[CRHBYTES],
+                             const uint8_t *pk)
+{
+  uint8_t c[CTILDEBYTES];
+  polyvecl z;
+  polyveck h;
+
+  if(unpack_and_check_sig(c, &z, &h, sig, siglen))
+    return -1;
+
+  return verify_mu(c, &z, &h, mu, pk);
+}
+
+/*************************************************
+* Name:        crypto_sign_expand_pk
+*
+* Description: Expands bit-packed public key into verification context
+*              holding tr = H(pk), matrix A and t1*2^d in NTT domain, so that
+*              repeated verification under the same key only performs the
+*              per-signature work.
+*
+* Arguments:   - expanded_pk *epk: pointer to output expanded public key
+*              - uint8_t *pk:      pointer to bit-packed public key
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_expand_pk(expanded_pk *epk, const uint8_t *pk)
+{
+  uint8_t rho[SEEDBYTES];
+
+  unpack_pk(rho, &epk->t1, pk);
+  shake256(epk->tr, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+
+  /* Expand matrix and transform t1*2^d */
+  polyvec_matrix_expand(epk->mat, rho);
+  polyveck_shiftl(&epk->t1);
+  polyveck_ntt(&epk->t1);
+
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_expanded_internal
+*
+* Description: Verifies signature with expanded public key. Internal API.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - const expanded_pk *epk: pointer to expanded public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_expanded_internal(const uint8_t *sig,
+                                         size_t siglen,
+                                         const uint8_t *m,
+                                         size_t mlen,
+                                         const uint8_t *pre,
+                                         size_t prelen,
+                                         const expanded_pk *epk)
+{
+  uint8_t mu[CRHBYTES];
+  uint8_t c[CTILDEBYTES];
+  polyvecl z;
+  polyveck h;
+  keccak_state state;
+
+  if(unpack_and_check_sig(c, &z, &h, sig, siglen))
+    return -1;
+
+  /* Compute CRH(tr, pre, msg) */
+  shake256_init(&state);
+  shake256_absorb(&state, epk->tr, TRBYTES);
+  shake256_absorb(&state, pre, prelen);
+  shake256_absorb(&state, m, mlen);
+  shake256_finalize(&state);
+  shake256_squeeze(mu, CRHBYTES, &state);
+
+  return verify_core(c, &z, &h, mu, epk->mat, &epk->t1);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_expanded
+*
+* Description: Verifies signature with expanded public key.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const expanded_pk *epk: pointer to expanded public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_expanded(const uint8_t *sig,
+                                size_t siglen,
+                                const uint8_t *m,
+                                size_t mlen,
+                                const uint8_t *ctx,
+                                size_t ctxlen,
+                                const expanded_pk *epk)
+{
+  size_t i;
+  uint8_t pre[257];
+
+  if(ctxlen > 255)
+    return -1;
+
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  for(i = 0; i < ctxlen; i++)
+    pre[2 + i] = ctx[i];
+
+  return crypto_sign_verify_expanded_internal(sig,siglen,m,mlen,pre,2+ctxlen,epk);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_batch
+*
+* Description: Verifies n independent signatures. Result i equals the
+*              return value of crypto_sign_verify on the i-th tuple.
+*
+* Arguments:   - int *ret: pointer to output array of n results
+*                          (0 if i-th signature is valid, -1 otherwise)
+*              - const uint8_t *const sig[]: array of n signatures
+*              - const size_t siglen[]: array of signature lengths
+*              - const uint8_t *const m[]: array of n messages
+*              - const size_t mlen[]: array of message lengths
+*              - const uint8_t *const ctx[]: array of n context strings
+*              - const size_t ctxlen[]: array of context string lengths
+*              - const uint8_t *const pk[]: array of n bit-packed public keys
+*              - size_t n: number of signatures
+*
+* Returns 0 if all signatures could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_batch(int *ret,
+                             const uint8_t *const sig[], const size_t siglen[],
+                             const uint8_t *const m[], const size_t mlen[],
+                             const uint8_t *const ctx[], const size_t ctxlen[],
+                             const uint8_t *const pk[], size_t n)
+{
+  size_t i;
+  int res = 0;
+
+  for(i = 0; i < n; ++i) {
+    ret[i] = crypto_sign_verify(sig[i], siglen[i], m[i], mlen[i], ctx[i], ctxlen[i], pk[i]);
+    res |= ret[i];
+  }
+
+  return res;
+}
+
+/*************************************************
+* Name:        crypto_sign_open_inplace
+*
+* Description: Verify signed message without copying the message.
+*
+* Arguments:   - const uint8_t **m: pointer to output pointer to message
+*                                   inside sm; set to NULL on failure
+*              - size_t *mlen: pointer to output length of message
+*              - const uint8_t *sm: pointer to signed message
+*              - size_t smlen: length of signed message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signed message could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_open_inplace(const uint8_t **m, size_t *mlen,
+                             const uint8_t *sm, size_t smlen,
+                             const uint8_t *ctx, size_t ctxlen,
+                             const uint8_t *pk)
+{
+  *m = NULL;
+  *mlen = 0;
+  if(smlen < CRYPTO_BYTES)
+    return -1;
+
+  if(crypto_sign_verify(sm, CRYPTO_BYTES, sm + CRYPTO_BYTES, smlen - CRYPTO_BYTES, ctx, ctxlen, pk))
+    return -1;
+
+  *m = sm + CRYPTO_BYTES;
+  *mlen = smlen - CRYPTO_BYTES;
+  return 0;
 }
 
 /*************************************************
@@ -404,7 +1362,7 @@ int crypto_sign_verify(const uint8_t *sig,
 *              - size_t *mlen: pointer to output length of message
 *              - const uint8_t *sm: pointer to signed message
 *              - size_t smlen: length of signed message
-*              - const uint8_t *ctx: pointer to context tring
+*              - const uint8_t *ctx: pointer to context string
 *              - size_t ctxlen: length of context string
 *              - const uint8_t *pk: pointer to bit-packed public key
 *
@@ -418,26 +1376,15 @@ int crypto_sign_open(uint8_t *m,
                      size_t ctxlen,
                      const uint8_t *pk)
 {
-  size_t i;
+  const uint8_t *msg;
 
-  if(smlen < CRYPTO_BYTES)
-    goto badsig;
-
-  *mlen = smlen - CRYPTO_BYTES;
-  if(crypto_sign_verify(sm, CRYPTO_BYTES, sm + CRYPTO_BYTES, *mlen, ctx, ctxlen, pk))
-    goto badsig;
-  else {
-    /* All good, copy msg, return 0 */
-    for(i = 0; i < *mlen; ++i)
-      m[i] = sm[CRYPTO_BYTES + i];
-    return 0;
+  if(crypto_sign_open_inplace(&msg, mlen, sm, smlen, ctx, ctxlen, pk)) {
+    /* Signature verification failed */
+    memset(m, 0, smlen);
+    return -1;
   }
 
-badsig:
-  /* Signature verification failed */
-  *mlen = 0;
-  for(i = 0; i < smlen; ++i)
-    m[i] = 0;
-
-  return -1;
+  /* All good, move msg, return 0 */
+  memmove(m, msg, *mlen);
+  return 0;
 }
@@ -6,10 +6,85 @@
 #include "params.h"
 #include "polyvec.h"
 #include "poly.h"
+#include "fips202.h"
+
+/* Secret key expanded for repeated signing; matrix in NTT domain, s1 and s2
+ * in normal domain, t0 in normal domain in ref/ and in NTT domain in avx2/ */
+typedef struct {
+  uint8_t key[SEEDBYTES];
+  uint8_t tr[TRBYTES];
+  polyvecl mat[K];
+  polyvecl s1;
+  polyveck s2;
+  polyveck t0;
+} expanded_sk;
+
+/* Public key expanded for repeated verification; matrix and t1*2^d in NTT domain */
+typedef struct {
+  uint8_t tr[TRBYTES];
+  polyvecl mat[K];
+  polyveck t1;
+} expanded_pk;
+
+/* Incremental signing; message chunks are absorbed into mu as they arrive */
+typedef struct {
+  keccak_state mu;
+  const uint8_t *sk;
+} sign_state;
+
+/* Incremental verification; signature is unpacked and checked up front */
+typedef struct {
+  keccak_state mu;
+  const uint8_t *pk;
+  uint8_t c[CTILDEBYTES];
+  polyvecl z;
+  polyveck h;
+} verify_state;
+
+/* Message segment for scatter-gather signing and verification */
+typedef struct {
+  const uint8_t *base;
+  size_t len;
+} sign_iovec;
+
+#define crypto_sign_seed_keypair DILITHIUM_NAMESPACE(seed_keypair)
+int crypto_sign_seed_keypair(uint8_t *pk, uint8_t *sk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]);
 
 #define crypto_sign_keypair DILITHIUM_NAMESPACE(keypair)
 int crypto_sign_keypair(uint8_t *pk, uint8_t *sk);
 
+#define crypto_sign_seed_keypair_x4 DILITHIUM_NAMESPACE(seed_keypair_x4)
+int crypto_sign_seed_keypair_x4(uint8_t *pk[4], uint8_t *sk[4], const uint8_t *seed[4]);
+
+#define crypto_sign_keypair_x4 DILITHIUM_NAMESPACE(keypair_x4)
+int crypto_sign_keypair_x4(uint8_t *pk[4], uint8_t *sk[4]);
+
+#define crypto_sign_seed_expand DILITHIUM_NAMESPACE(seed_expand)
+int crypto_sign_seed_expand(uint8_t *sk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]);
+
+#define crypto_sign_expand_sk DILITHIUM_NAMESPACE(expand_sk)
+int crypto_sign_expand_sk(expanded_sk *esk, const uint8_t *sk);
+
+#define crypto_sign_seed_expand_sk DILITHIUM_NAMESPACE(seed_expand_sk)
+int crypto_sign_seed_expand_sk(expanded_sk *esk, const uint8_t seed[CRYPTO_SEEDKEYBYTES]);
+
+#define crypto_sign_signature_attempt DILITHIUM_NAMESPACE(signature_attempt)
+int crypto_sign_signature_attempt(uint8_t sig[CRYPTO_BYTES],
+                                  const uint8_t mu[CRHBYTES],
+                                  const uint8_t rhoprime[CRHBYTES],
+                                  uint16_t nonce,
+                                  const expanded_sk *esk);
+
+#define crypto_sign_signature_expanded_internal DILITHIUM_NAMESPACE(signature_expanded_internal)
+int crypto_sign_signature_expanded_internal(uint8_t *sig,
+                                            size_t *siglen,
+                                            const uint8_t *m,
+                                            size_t mlen,
+                                            const uint8_t *pre,
+                                            size_t prelen,
+                                            const uint8_t rnd[RNDBYTES],
+                                            const expanded_sk *esk);
+
 #define crypto_sign_signature_internal DILITHIUM_NAMESPACE(signature_internal)
 int crypto_sign_signature_internal(uint8_t *sig,
                                    size_t *siglen,
@@ -26,6 +101,52 @@ int crypto_sign_signature(uint8_t *sig, size_t *siglen,
                           const uint8_t *ctx, size_t ctxlen,
                           const uint8_t *sk);
 
+#define crypto_sign_signature_expanded DILITHIUM_NAMESPACE(signature_expanded)
+int crypto_sign_signature_expanded(uint8_t *sig, size_t *siglen,
+                                   const uint8_t *m, size_t mlen,
+                                   const uint8_t *ctx, size_t ctxlen,
+                                   const expanded_sk *esk);
+
+#define crypto_sign_signature_batch_internal DILITHIUM_NAMESPACE(signature_batch_internal)
+int crypto_sign_signature_batch_internal(uint8_t *const sig[], size_t siglen[],
+                                         const uint8_t *const m[], const size_t mlen[],
+                                         const uint8_t *pre, size_t prelen,
+                                         const uint8_t *const rnd[],
+                                         const expanded_sk *esk, size_t n);
+
+#define crypto_sign_signature_batch DILITHIUM_NAMESPACE(signature_batch)
+int crypto_sign_signature_batch(uint8_t *const sig[], size_t siglen[],
+                                const uint8_t *const m[], const size_t mlen[],
+                                const uint8_t *ctx, size_t ctxlen,
+                                const uint8_t *sk, size_t n);
+
+#define crypto_sign_init DILITHIUM_NAMESPACE(init)
+int crypto_sign_init(sign_state *state, const uint8_t *sk,
+                     const uint8_t *ctx, size_t ctxlen);
+
+#define crypto_sign_update DILITHIUM_NAMESPACE(update)
+void crypto_sign_update(sign_state *state, const uint8_t *m, size_t mlen);
+
+#define crypto_sign_final DILITHIUM_NAMESPACE(final)
+int crypto_sign_final(sign_state *state, uint8_t *sig, size_t *siglen);
+
+#define crypto_sign_signature_iov DILITHIUM_NAMESPACE(signature_iov)
+int crypto_sign_signature_iov(uint8_t *sig, size_t *siglen,
+                              const sign_iovec *iov, size_t iovcnt,
+                              const uint8_t *ctx, size_t ctxlen,
+                              const uint8_t *sk);
+
+#define crypto_sign_compute_mu DILITHIUM_NAMESPACE(compute_mu)
+int crypto_sign_compute_mu(uint8_t mu[CRHBYTES],
+                           const uint8_t *m, size_t mlen,
+                           const uint8_t *ctx, size_t ctxlen,
+                           const uint8_t *pk);
+
+#define crypto_sign_signature_extmu DILITHIUM_NAMESPACE(signature_extmu)
+int crypto_sign_signature_extmu(uint8_t *sig, size_t *siglen,
+                                const uint8_t mu[CRHBYTES],
+                                const uint8_t *sk);
+
 #define crypto_sign DILITHIUM_NAMESPACETOP
 int crypto_sign(uint8_t *sm, size_t *smlen,
                 const uint8_t *m, size_t mlen,
@@ -47,10 +168,64 @@ int crypto_sign_verify(const uint8_t *sig, size_t siglen,
                        const uint8_t *ctx, size_t ctxlen,
                        const uint8_t *pk);
 
+#define crypto_sign_verify_init DILITHIUM_NAMESPACE(verify_init)
+int crypto_sign_verify_init(verify_state *state,
+                            const uint8_t *sig, size_t siglen,
+                            const uint8_t *ctx, size_t ctxlen,
+                            const uint8_t *pk);
+
+#define crypto_sign_verify_update DILITHIUM_NAMESPACE(verify_update)
+void crypto_sign_verify_update(verify_state *state, const uint8_t *m, size_t mlen);
+
+#define crypto_sign_verify_final DILITHIUM_NAMESPACE(verify_final)
+int crypto_sign_verify_final(verify_state *state);
+
+#define crypto_sign_verify_iov DILITHIUM_NAMESPACE(verify_iov)
+int crypto_sign_verify_iov(const uint8_t *sig, size_t siglen,
+                           const sign_iovec *iov, size_t iovcnt,
+                           const uint8_t *ctx, size_t ctxlen,
+                           const uint8_t *pk);
+
+#define crypto_sign_verify_extmu DILITHIUM_NAMESPACE(verify_extmu)
+int crypto_sign_verify_extmu(const uint8_t *sig, size_t siglen,
+                             const uint8_t mu[CRHBYTES],
+                             const uint8_t *pk);
+
+#define crypto_sign_expand_pk DILITHIUM_NAMESPACE(expand_pk)
+int crypto_sign_expand_pk(expanded_pk *epk, const uint8_t *pk);
+
+#define crypto_sign_verify_expanded_internal DILITHIUM_NAMESPACE(verify_expanded_internal)
+int crypto_sign_verify_expanded_internal(const uint8_t *sig,
+                                         size_t siglen,
+                                         const uint8_t *m,
+                                         size_t mlen,
+                                         const uint8_t *pre,
+                                         size_t prelen,
+                                         const expanded_pk *epk);
+
+#define crypto_sign_verify_expanded DILITHIUM_NAMESPACE(verify_expanded)
+int crypto_sign_verify_expanded(const uint8_t *sig, size_t siglen,
+                                const uint8_t *m, size_t mlen,
+                                const uint8_t *ctx, size_t ctxlen,
+                                const expanded_pk *epk);
+
+#define crypto_sign_verify_batch DILITHIUM_NAMESPACE(verify_batch)
+int crypto_sign_verify_batch(int *ret,
+                             const uint8_t *const sig[], const size_t siglen[],
+                             const uint8_t *const m[], const size_t mlen[],
+                             const uint8_t *const ctx[], const size_t ctxlen[],
+                             const uint8_t *const pk[], size_t n);
+
 #define crypto_sign_open DILITHIUM_NAMESPACE(open)
 int crypto_sign_open(uint8_t *m, size_t *mlen,
                      const uint8_t *sm, size_t smlen,
                      const uint8_t *ctx, size_t ctxlen,
                      const uint8_t *pk);
 
+#define crypto_sign_open_inplace DILITHIUM_NAMESPACE(open_inplace)
+int crypto_sign_open_inplace(const uint8_t **m, size_t *mlen,
+                             const uint8_t *sm, size_t smlen,
+                             const uint8_t *ctx, size_t ctxlen,
+                             const uint8_t *pk);
+
 #endif
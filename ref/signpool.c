@@ -0,0 +1,298 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "params.h"
+#include "sign.h"
+#include "signpool.h"
+#include "randombytes.h"
+#include "fips202.h"
+
+/* Speculative parallel signing. The calling thread and the helper threads
+ * claim consecutive attempt numbers of the rejection loop from a shared
+ * counter and evaluate them concurrently. A thread stops claiming once an
+ * attempt below its next number has been accepted, and the request only
+ * returns after all threads stopped. Every attempt below the lowest
+ * accepted one has therefore been evaluated and rejected, so the result
+ * is the signature the sequential loop would have produced. */
+
+typedef struct {
+  uint8_t sig[CRYPTO_BYTES];
+  signpool *pool;
+  pthread_t thread;
+} helper;
+
+struct signpool {
+  helper *helpers;
+  unsigned int nthreads;
+  pthread_mutex_t lock;
+  pthread_mutex_t statelock;
+  pthread_cond_t start;
+  pthread_cond_t finished;
+  unsigned long generation;
+  unsigned int running;
+  int stop;
+  /* Current request */
+  const uint8_t *mu;
+  const uint8_t *rhoprime;
+  const expanded_sk *esk;
+  uint8_t *sig;
+  uint8_t ownsig[CRYPTO_BYTES];
+  atomic_uint next;
+  atomic_uint best;
+  pthread_mutex_t bestlock;
+};
+
+static void search(signpool *pool, uint8_t sig[CRYPTO_BYTES]) {
+  unsigned int k;
+
+  for(;;) {
+    k = atomic_fetch_add(&pool->next, 1);
+    if(k >= atomic_load(&pool->best))
+      return;
+
+    if(crypto_sign_signature_attempt(sig, pool->mu, pool->rhoprime, k, pool->esk))
+      continue;
+
+    /* Later attempts of this thread cannot win */
+    pthread_mutex_lock(&pool->bestlock);
+    if(k < atomic_load(&pool->best)) {
+      memcpy(pool->sig, sig, CRYPTO_BYTES);
+      atomic_store(&pool->best, k);
+    }
+    pthread_mutex_unlock(&pool->bestlock);
+    return;
+  }
+}
+
+static void *helper_main(void *arg) {
+  unsigned long generation = 0;
+  helper *h = arg;
+  signpool *pool = h->pool;
+
+  for(;;) {
+    pthread_mutex_lock(&pool->statelock);
+    while(pool->generation == generation && !pool->stop)
+      pthread_cond_wait(&pool->start, &pool->statelock);
+    if(pool->stop) {
+      pthread_mutex_unlock(&pool->statelock);
+      break;
+    }
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->statelock);
+
+    search(pool, h->sig);
+
+    pthread_mutex_lock(&pool->statelock);
+    if(--pool->running == 0)
+      pthread_cond_signal(&pool->finished);
+    pthread_mutex_unlock(&pool->statelock);
+  }
+
+  return NULL;
+}
+
+/*************************************************
+* Name:        signpool_create
+*
+* Description: Starts helper threads for speculative parallel signing.
+*
+* Arguments:   - unsigned int nthreads: number of helper threads; signing
+*                                       also uses the calling thread
+*
+* Returns pointer to pool or NULL on failure
+**************************************************/
+signpool *signpool_create(unsigned int nthreads) {
+  unsigned int i;
+  pthread_attr_t attr;
+  signpool *pool;
+
+  pool = calloc(1, sizeof(signpool));
+  if(!pool)
+    return NULL;
+
+  pool->helpers = calloc(nthreads ? nthreads : 1, sizeof(helper));
+  if(!pool->helpers) {
+    free(pool);
+    return NULL;
+  }
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_mutex_init(&pool->statelock, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->finished, NULL);
+  pthread_mutex_init(&pool->bestlock, NULL);
+
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, SIGNPOOL_STACK_BYTES);
+  for(i = 0; i < nthreads; ++i) {
+    pool->helpers[i].pool = pool;
+    if(pthread_create(&pool->helpers[i].thread, &attr, helper_main, &pool->helpers[i]))
+      break;
+    pool->nthreads++;
+  }
+  pthread_attr_destroy(&attr);
+
+  if(pool->nthreads != nthreads) {
+    signpool_destroy(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+/*************************************************
+* Name:        signpool_destroy
+*
+* Description: Stops the helper threads and frees the pool.
+*
+* Arguments:   - signpool *pool: pointer to pool
+**************************************************/
+void signpool_destroy(signpool *pool) {
+  unsigned int i;
+
+  pthread_mutex_lock(&pool->statelock);
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->statelock);
+
+  for(i = 0; i < pool->nthreads; ++i)
+    pthread_join(pool->helpers[i].thread, NULL);
+
+  pthread_mutex_destroy(&pool->lock);
+  pthread_mutex_destroy(&pool->statelock);
+  pthread_cond_destroy(&pool->start);
+  pthread_cond_destroy(&pool->finished);
+  pthread_mutex_destroy(&pool->bestlock);
+  free(pool->helpers);
+  free(pool);
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_parallel_internal
+*
+* Description: Computes signature, evaluating consecutive attempts of the
+*              rejection loop concurrently on the threads of the pool.
+*              Output is identical to crypto_sign_signature_expanded_internal.
+*              Requests on the same pool are serialized. Internal API.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m: pointer to message to be signed
+*              - size_t mlen: length of message
+*              - uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - uint8_t *rnd: pointer to random seed
+*              - const expanded_sk *esk: pointer to expanded secret key
+*              - signpool *pool: pointer to pool
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_sign_signature_parallel_internal(uint8_t *sig,
+                                            size_t *siglen,
+                                            const uint8_t *m,
+                                            size_t mlen,
+                                            const uint8_t *pre,
+                                            size_t prelen,
+                                            const uint8_t rnd[RNDBYTES],
+                                            const expanded_sk *esk,
+                                            signpool *pool)
+{
+  uint8_t seedbuf[2*CRHBYTES];
+  uint8_t *mu, *rhoprime;
+  keccak_state state;
+
+  mu = seedbuf;
+  rhoprime = mu + CRHBYTES;
+
+  /* Compute mu = CRH(tr, pre, msg) */
+  shake256_init(&state);
+  shake256_absorb(&state, esk->tr, TRBYTES);
+  shake256_absorb(&state, pre, prelen);
+  shake256_absorb(&state, m, mlen);
+  shake256_finalize(&state);
+  shake256_squeeze(mu, CRHBYTES, &state);
+
+  /* Compute rhoprime = CRH(key, rnd, mu) */
+  shake256_init(&state);
+  shake256_absorb(&state, esk->key, SEEDBYTES);
+  shake256_absorb(&state, rnd, RNDBYTES);
+  shake256_absorb(&state, mu, CRHBYTES);
+  shake256_finalize(&state);
+  shake256_squeeze(rhoprime, CRHBYTES, &state);
+
+  pthread_mutex_lock(&pool->lock);
+  pool->mu = mu;
+  pool->rhoprime = rhoprime;
+  pool->esk = esk;
+  pool->sig = sig;
+  atomic_store(&pool->next, 0);
+  atomic_store(&pool->best, UINT_MAX);
+
+  pthread_mutex_lock(&pool->statelock);
+  pool->generation++;
+  pool->running = pool->nthreads;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->statelock);
+
+  search(pool, pool->ownsig);
+
+  pthread_mutex_lock(&pool->statelock);
+  while(pool->running)
+    pthread_cond_wait(&pool->finished, &pool->statelock);
+  pthread_mutex_unlock(&pool->statelock);
+  pthread_mutex_unlock(&pool->lock);
+
+  *siglen = CRYPTO_BYTES;
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_sign_signature_parallel
+*
+* Description: Computes signature from expanded secret key using the
+*              threads of the pool. Output is identical to
+*              crypto_sign_signature_expanded.
+*
+* Arguments:   - uint8_t *sig: pointer to output signature (of length CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m: pointer to message to be signed
+*              - size_t mlen: length of message
+*              - uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const expanded_sk *esk: pointer to expanded secret key
+*              - signpool *pool: pointer to pool
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int crypto_sign_signature_parallel(uint8_t *sig, size_t *siglen,
+                                   const uint8_t *m, size_t mlen,
+                                   const uint8_t *ctx, size_t ctxlen,
+                                   const expanded_sk *esk,
+                                   signpool *pool)
+{
+  size_t i;
+  uint8_t pre[257];
+  uint8_t rnd[RNDBYTES];
+
+  if(ctxlen > 255)
+    return -1;
+
+  /* Prepare pre = (0, ctxlen, ctx) */
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  for(i = 0; i < ctxlen; i++)
+    pre[2 + i] = ctx[i];
+
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+  randombytes(rnd, RNDBYTES);
+#else
+  for(i = 0; i < RNDBYTES; i++)
+    rnd[i] = 0;
+#endif
+
+  return crypto_sign_signature_parallel_internal(sig, siglen, m, mlen, pre, 2 + ctxlen, rnd, esk, pool);
+}
@@ -0,0 +1,40 @@
+#ifndef SIGNPOOL_H
+#define SIGNPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "params.h"
+#include "sign.h"
+
+/* Stack of helper threads */
+#ifndef SIGNPOOL_STACK_BYTES
+#define SIGNPOOL_STACK_BYTES (1 << 18)
+#endif
+
+typedef struct signpool signpool;
+
+#define signpool_create DILITHIUM_NAMESPACE(signpool_create)
+signpool *signpool_create(unsigned int nthreads);
+
+#define signpool_destroy DILITHIUM_NAMESPACE(signpool_destroy)
+void signpool_destroy(signpool *pool);
+
+#define crypto_sign_signature_parallel_internal DILITHIUM_NAMESPACE(signature_parallel_internal)
+int crypto_sign_signature_parallel_internal(uint8_t *sig,
+                                            size_t *siglen,
+                                            const uint8_t *m,
+                                            size_t mlen,
+                                            const uint8_t *pre,
+                                            size_t prelen,
+                                            const uint8_t rnd[RNDBYTES],
+                                            const expanded_sk *esk,
+                                            signpool *pool);
+
+#define crypto_sign_signature_parallel DILITHIUM_NAMESPACE(signature_parallel)
+int crypto_sign_signature_parallel(uint8_t *sig, size_t *siglen,
+                                   const uint8_t *m, size_t mlen,
+                                   const uint8_t *ctx, size_t ctxlen,
+                                   const expanded_sk *esk,
+                                   signpool *pool);
+
+#endif
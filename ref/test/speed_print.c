@@ -4,6 +4,17 @@
 #include <stdio.h>
 #include "cpucycles.h"
 #include "speed_print.h"
+#include "../dbench.h"
+
+#ifdef DBENCH
+uint64_t timing_overhead;
+_Thread_local uint64_t dbench_counters[9];
+
+static const char *const counter_names[9] = {
+  "reduce", "add/sub", "pointwise", "ntt", "invntt", "rounding",
+  "sampling", "packing", "keccak"
+};
+#endif
 
 static int cmp_uint64(const void *a, const void *b) {
   if(*(uint64_t *)a < *(uint64_t *)b) return -1;
@@ -49,3 +60,29 @@ void print_results(const char *s, uint64_t *t, size_t tlen) {
   printf("average: %llu cycles/ticks\n", (unsigned long long)average(t, tlen));
   printf("\n");
 }
+
+#ifdef DBENCH
+void dbench_reset(void) {
+  size_t i;
+
+  if(!timing_overhead)
+    timing_overhead = cpucycles_overhead();
+
+  for(i=0;i<9;i++)
+    dbench_counters[i] = 0;
+}
+
+void print_dbench(const char *s, size_t nops) {
+  size_t i;
+  uint64_t sum=0;
+
+  printf("%s\n", s);
+  for(i=0;i<9;i++) {
+    printf("%-10s %10llu cycles/op\n", counter_names[i],
+           (unsigned long long)(dbench_counters[i]/nops));
+    sum += dbench_counters[i];
+  }
+  printf("%-10s %10llu cycles/op\n", "total", (unsigned long long)(sum/nops));
+  printf("\n");
+}
+#endif
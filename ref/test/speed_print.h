@@ -6,4 +6,12 @@
 
 void print_results(const char *s, uint64_t *t, size_t tlen);
 
+#ifdef DBENCH
+void dbench_reset(void);
+void print_dbench(const char *s, size_t nops);
+#else
+#define dbench_reset()
+#define print_dbench(s, nops)
+#endif
+
 #endif
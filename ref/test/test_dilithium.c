@@ -3,10 +3,519 @@
 #include <stdio.h>
 #include "../randombytes.h"
 #include "../sign.h"
+#include "../poly.h"
+#include "../pkcache.h"
+#include "../verifypool.h"
+#include "../signpool.h"
+#include "../prehash.h"
 
 #define MLEN 59
 #define CTXLEN 14
 #define NTESTS 10000
+#define NKEYGEN 100
+#define NBATCH 50
+#define NAPI 1000
+#define NCACHE 100
+#define BATCH 7
+#define BATCHMLEN 512
+#define POOLTHREADS 3
+#define SIGNTHREADS 3
+#define POOLJOBS (8*BATCH)
+
+static atomic_int callbacks;
+
+static void count_callback(verifypool_job *job)
+{
+  (void)job;
+  atomic_fetch_add(&callbacks, 1);
+}
+
+static int verify_streamed(const uint8_t *sig, const uint8_t *m, size_t mlen, size_t split,
+                           const uint8_t *ctx, size_t ctxlen, const uint8_t *pk)
+{
+  verify_state vst;
+
+  if(crypto_sign_verify_init(&vst, sig, CRYPTO_BYTES, ctx, ctxlen, pk))
+    return -1;
+  crypto_sign_verify_update(&vst, m, split);
+  crypto_sign_verify_update(&vst, m + split, mlen - split);
+  return crypto_sign_verify_final(&vst);
+}
+
+static int test_keygen(void)
+{
+  size_t i, j, k;
+  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
+  uint8_t sk[CRYPTO_SECRETKEYBYTES];
+  uint8_t sk2[CRYPTO_SECRETKEYBYTES];
+  uint8_t seeds[4][CRYPTO_SEEDKEYBYTES];
+  uint8_t pks[4][CRYPTO_PUBLICKEYBYTES];
+  uint8_t sks[4][CRYPTO_SECRETKEYBYTES];
+  uint8_t *pkp[4], *skp[4];
+  const uint8_t *seedp[4];
+
+  for(i = 0; i < NKEYGEN; ++i) {
+    /* Batched key generation matches single key generation */
+    randombytes(seeds[0], sizeof(seeds));
+    for(j = 0; j < 4; ++j) {
+      pkp[j] = pks[j];
+      skp[j] = sks[j];
+      seedp[j] = seeds[j];
+    }
+    crypto_sign_seed_keypair_x4(pkp, skp, seedp);
+    for(k = 0; k < 4; ++k) {
+      crypto_sign_seed_keypair(pk, sk, seeds[k]);
+      for(j = 0; j < CRYPTO_PUBLICKEYBYTES; ++j) {
+        if(pks[k][j] != pk[j]) {
+          fprintf(stderr, "Batched public keys don't match\n");
+          return -1;
+        }
+      }
+      for(j = 0; j < CRYPTO_SECRETKEYBYTES; ++j) {
+        if(sks[k][j] != sk[j]) {
+          fprintf(stderr, "Batched secret keys don't match\n");
+          return -1;
+        }
+      }
+
+      /* Secret key can be recomputed from the seed */
+      crypto_sign_seed_expand(sk2, seeds[k]);
+      for(j = 0; j < CRYPTO_SECRETKEYBYTES; ++j) {
+        if(sk2[j] != sk[j]) {
+          fprintf(stderr, "Secret keys expanded from seed don't match\n");
+          return -1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+static int test_batch(const uint8_t *ctx, const uint8_t *pre, size_t prelen)
+{
+  size_t i, j, k;
+  int ret;
+  uint8_t b;
+  uint8_t pks[4][CRYPTO_PUBLICKEYBYTES];
+  uint8_t sks[4][CRYPTO_SECRETKEYBYTES];
+  uint8_t *pkp[4], *skp[4];
+  uint8_t bm[BATCH][BATCHMLEN];
+  uint8_t bsig[BATCH][CRYPTO_BYTES];
+  const uint8_t *bsigp[BATCH], *bmp[BATCH], *bctxp[BATCH], *bpkp[BATCH];
+  size_t bsiglen[BATCH], bmlen[BATCH], bctxlen[BATCH];
+  int bret[BATCH];
+  uint8_t brnd[BATCH][RNDBYTES];
+  uint8_t *bsigo[BATCH];
+  const uint8_t *brndp[BATCH];
+  uint8_t sig[CRYPTO_BYTES];
+  uint8_t sig2[CRYPTO_BYTES];
+  poly zp;
+  uint8_t ph[5][PREHASH_MAXBYTES];
+  uint8_t *php[4];
+  size_t phlen, phmlen[4];
+  size_t siglen;
+  expanded_sk esk;
+  verifypool *pool;
+  signpool *spool;
+  verifypool_job jobs[POOLJOBS];
+
+  spool = signpool_create(SIGNTHREADS);
+  if(!spool) {
+    fprintf(stderr, "Signing pool creation failed\n");
+    return -1;
+  }
+
+  for(i = 0; i < NBATCH; ++i) {
+    for(j = 0; j < 4; ++j) {
+      pkp[j] = pks[j];
+      skp[j] = sks[j];
+    }
+    crypto_sign_keypair_x4(pkp, skp);
+
+    /* Batch verification agrees with single verification */
+    randombytes(bm[0], sizeof(bm));
+    for(k = 0; k < BATCH; ++k) {
+      bmlen[k] = BATCHMLEN - 73*k;
+      bctxlen[k] = (k & 1) ? CTXLEN : 0;
+      crypto_sign_signature(bsig[k], &bsiglen[k], bm[k], bmlen[k], ctx, bctxlen[k], sks[k % 4]);
+      bsigp[k] = bsig[k];
+      bmp[k] = bm[k];
+      bctxp[k] = ctx;
+      bpkp[k] = pks[k % 4];
+    }
+    bsig[1][CRYPTO_BYTES - 1 - i % 64] ^= 1;
+    bsiglen[4] -= 1;
+    /* z just outside the norm bound is still unpackable */
+    polyz_unpack(&zp, bsig[2] + CTILDEBYTES);
+    zp.coeffs[i % N] = (i & 1) ? GAMMA1 - BETA : -(GAMMA1 - BETA);
+    polyz_pack(bsig[2] + CTILDEBYTES, &zp);
+    ret = crypto_sign_verify_batch(bret, bsigp, bsiglen, bmp, bmlen, bctxp, bctxlen, bpkp, BATCH);
+    if(!ret || bret[0] || !bret[1] || !bret[2] || !bret[4]) {
+      fprintf(stderr, "Batch verification failed\n");
+      return -1;
+    }
+    for(k = 0; k < BATCH; ++k) {
+      if(bret[k] != crypto_sign_verify(bsig[k], bsiglen[k], bm[k], bmlen[k], ctx, bctxlen[k], pks[k % 4])) {
+        fprintf(stderr, "Batch verification results wrong\n");
+        return -1;
+      }
+    }
+
+    /* Batch signing matches single signing */
+    randombytes(brnd[0], sizeof(brnd));
+    for(k = 0; k < BATCH; ++k) {
+      bsigo[k] = bsig[k];
+      brndp[k] = brnd[k];
+    }
+    crypto_sign_expand_sk(&esk, sks[0]);
+    crypto_sign_signature_batch_internal(bsigo, bsiglen, bmp, bmlen, pre, prelen, brndp, &esk, BATCH);
+    for(k = 0; k < BATCH; ++k) {
+      crypto_sign_signature_expanded_internal(sig, &siglen, bm[k], bmlen[k], pre, prelen, brnd[k], &esk);
+      if(bsiglen[k] != siglen) {
+        fprintf(stderr, "Batch signature lengths wrong\n");
+        return -1;
+      }
+      for(j = 0; j < CRYPTO_BYTES; ++j) {
+        if(bsig[k][j] != sig[j]) {
+          fprintf(stderr, "Batch signatures don't match\n");
+          return -1;
+        }
+      }
+
+      /* Speculative parallel signing matches sequential signing */
+      crypto_sign_signature_parallel_internal(sig2, &siglen, bm[k], bmlen[k], pre, prelen, brnd[k], &esk, spool);
+      for(j = 0; j < CRYPTO_BYTES; ++j) {
+        if(sig2[j] != sig[j]) {
+          fprintf(stderr, "Parallel signatures don't match\n");
+          return -1;
+        }
+      }
+    }
+
+    /* Short batches leave lanes idle */
+    k = 1 + i % BATCH;
+    crypto_sign_signature_batch(bsigo, bsiglen, bmp, bmlen, ctx, CTXLEN, sks[1], k);
+    for(j = 0; j < BATCH; ++j) {
+      bctxlen[j] = CTXLEN;
+      bpkp[j] = pks[1];
+    }
+    if(crypto_sign_verify_batch(bret, bsigp, bsiglen, bmp, bmlen, bctxp, bctxlen, bpkp, k)) {
+      fprintf(stderr, "Verification of batch signatures failed\n");
+      return -1;
+    }
+
+    /* Batched pre-hashing matches single pre-hashing */
+    for(k = 0; k < 4; ++k) {
+      php[k] = ph[k];
+      phmlen[k] = bmlen[k];
+    }
+    phmlen[3] = i % 300;
+    for(b = PREHASH_SHA3_256; b <= PREHASH_SHAKE128; ++b) {
+      if(crypto_sign_prehash_x4(php, &phlen, b, bmp, phmlen)) {
+        fprintf(stderr, "Batched pre-hashing failed\n");
+        return -1;
+      }
+      for(k = 0; k < 4; ++k) {
+        crypto_sign_prehash(ph[4], &siglen, b, bm[k], phmlen[k]);
+        if(siglen != phlen) {
+          fprintf(stderr, "Pre-hash lengths wrong\n");
+          return -1;
+        }
+        for(j = 0; j < phlen; ++j) {
+          if(ph[k][j] != ph[4][j]) {
+            fprintf(stderr, "Batched pre-hashes don't match\n");
+            return -1;
+          }
+        }
+      }
+    }
+
+    /* Pre-hash signatures are bound to the digest algorithm */
+    if(crypto_sign_prehash(ph[4], &phlen, PREHASH_SHA512, bm[0], bmlen[0]) != -1) {
+      fprintf(stderr, "SHA-512 pre-hashing did not fail\n");
+      return -1;
+    }
+    crypto_sign_prehash(ph[0], &phlen, PREHASH_SHAKE128, bm[0], bmlen[0]);
+    crypto_sign_signature_prehash(sig, &siglen, ph[0], phlen, PREHASH_SHAKE128, ctx, CTXLEN, sks[0]);
+    if(crypto_sign_verify_prehash(sig, siglen, ph[0], phlen, PREHASH_SHAKE128, ctx, CTXLEN, pks[0])) {
+      fprintf(stderr, "Verification of pre-hash signature failed\n");
+      return -1;
+    }
+    if(!crypto_sign_verify_prehash(sig, siglen, ph[0], phlen, PREHASH_SHA3_256, ctx, CTXLEN, pks[0])
+       || !crypto_sign_verify(sig, siglen, ph[0], phlen, ctx, CTXLEN, pks[0])) {
+      fprintf(stderr, "Trivial forgeries possible\n");
+      return -1;
+    }
+
+    /* SHA-512 digests are supplied by the caller */
+    crypto_sign_signature_prehash(sig, &siglen, bm[1], PREHASH_MAXBYTES, PREHASH_SHA512, ctx, CTXLEN, sks[1]);
+    if(crypto_sign_verify_prehash(sig, siglen, bm[1], PREHASH_MAXBYTES, PREHASH_SHA512, ctx, CTXLEN, pks[1])) {
+      fprintf(stderr, "Verification of SHA-512 pre-hash signature failed\n");
+      return -1;
+    }
+  }
+
+  signpool_destroy(spool);
+
+  /* Verification pool agrees with single verification */
+  crypto_sign_signature_batch(bsigo, bsiglen, bmp, bmlen, ctx, CTXLEN, sks[1], BATCH);
+  pool = verifypool_create(POOLTHREADS);
+  if(!pool) {
+    fprintf(stderr, "Verification pool creation failed\n");
+    return -1;
+  }
+  for(i = 0; i < POOLJOBS; ++i) {
+    k = i % BATCH;
+    jobs[i].sig = bsig[k];
+    jobs[i].siglen = bsiglen[k] - (i % 5 == 1);
+    jobs[i].m = bm[k];
+    jobs[i].mlen = bmlen[k] - (i % 7 == 2);
+    jobs[i].ctx = ctx;
+    jobs[i].ctxlen = bctxlen[k];
+    jobs[i].pk = (i % 3) ? pks[1] : pks[2];
+    jobs[i].callback = (i & 1) ? count_callback : NULL;
+    verifypool_submit(pool, &jobs[i]);
+  }
+  for(i = 0; i < POOLJOBS; i += 2)
+    verifypool_wait(&jobs[i]);
+  verifypool_destroy(pool);
+
+  if(atomic_load(&callbacks) != POOLJOBS/2) {
+    fprintf(stderr, "Verification pool callbacks missing\n");
+    return -1;
+  }
+  for(i = 0; i < POOLJOBS; ++i) {
+    ret = crypto_sign_verify(jobs[i].sig, jobs[i].siglen, jobs[i].m, jobs[i].mlen,
+                             jobs[i].ctx, jobs[i].ctxlen, jobs[i].pk);
+    if(jobs[i].result != ret || (!(i & 1) && !verifypool_poll(&jobs[i]))) {
+      fprintf(stderr, "Verification pool results wrong\n");
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int test_api(const uint8_t *ctx)
+{
+  size_t i, j, k;
+  int ret;
+  size_t mlen, smlen;
+  uint8_t b;
+  uint8_t m[MLEN + CRYPTO_BYTES];
+  uint8_t m2[MLEN + CRYPTO_BYTES];
+  uint8_t sm[MLEN + CRYPTO_BYTES];
+  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
+  uint8_t sk[CRYPTO_SECRETKEYBYTES];
+  const uint8_t *mp;
+  uint8_t seed[CRYPTO_SEEDKEYBYTES];
+  uint8_t sig[CRYPTO_BYTES];
+  uint8_t sig2[CRYPTO_BYTES];
+  uint8_t rnd[RNDBYTES];
+  uint8_t mu[CRHBYTES];
+  size_t siglen;
+  expanded_sk esk;
+  expanded_pk epk;
+  sign_state sst;
+  verify_state vst;
+  sign_iovec iov[3];
+
+  for(i = 0; i < NAPI; ++i) {
+    randombytes(m, MLEN);
+    randombytes(seed, CRYPTO_SEEDKEYBYTES);
+    crypto_sign_seed_keypair(pk, sk, seed);
+    crypto_sign(sm, &smlen, m, MLEN, ctx, CTXLEN, sk);
+
+    /* In-place opening returns the message inside sm */
+    if(crypto_sign_open_inplace(&mp, &mlen, sm, smlen, ctx, CTXLEN, pk)
+       || mp != sm + CRYPTO_BYTES || mlen != MLEN) {
+      fprintf(stderr, "In-place opening failed\n");
+      return -1;
+    }
+
+    /* Signing and opening with message and signed message overlapping */
+    for(j = 0; j < MLEN; ++j)
+      m2[CRYPTO_BYTES + j] = m[j];
+    crypto_sign(m2, &smlen, m2 + CRYPTO_BYTES, MLEN, ctx, CTXLEN, sk);
+    if(crypto_sign_open(m2, &mlen, m2, smlen, ctx, CTXLEN, pk) || mlen != MLEN) {
+      fprintf(stderr, "Verification of in-place signed message failed\n");
+      return -1;
+    }
+    for(j = 0; j < MLEN; ++j) {
+      if(m2[j] != m[j]) {
+        fprintf(stderr, "In-place opened messages don't match\n");
+        return -1;
+      }
+    }
+
+    crypto_sign_expand_pk(&epk, pk);
+    if(crypto_sign_verify_expanded(sm, CRYPTO_BYTES, sm + CRYPTO_BYTES, MLEN, ctx, CTXLEN, &epk)) {
+      fprintf(stderr, "Verification with expanded public key failed\n");
+      return -1;
+    }
+
+    randombytes(rnd, RNDBYTES);
+    crypto_sign_signature_internal(sig, &siglen, m, MLEN, ctx, CTXLEN, rnd, sk);
+    if(i & 1)
+      crypto_sign_expand_sk(&esk, sk);
+    else
+      crypto_sign_seed_expand_sk(&esk, seed);
+    crypto_sign_signature_expanded_internal(sig2, &siglen, m, MLEN, ctx, CTXLEN, rnd, &esk);
+    for(j = 0; j < CRYPTO_BYTES; ++j) {
+      if(sig2[j] != sig[j]) {
+        fprintf(stderr, "Expanded secret key signatures don't match\n");
+        return -1;
+      }
+    }
+
+    /* Incremental signing over message split at random point */
+    randombytes((uint8_t *)&k, sizeof(k));
+    k %= MLEN + 1;
+    if(crypto_sign_init(&sst, sk, ctx, CTXLEN)) {
+      fprintf(stderr, "Incremental signing init failed\n");
+      return -1;
+    }
+    crypto_sign_update(&sst, m, k);
+    crypto_sign_update(&sst, m + k, MLEN - k);
+    crypto_sign_final(&sst, sig, &siglen);
+    if(siglen != CRYPTO_BYTES || crypto_sign_verify(sig, siglen, m, MLEN, ctx, CTXLEN, pk)) {
+      fprintf(stderr, "Verification of incremental signature failed\n");
+      return -1;
+    }
+    if(verify_streamed(sig, m, MLEN, MLEN - k, ctx, CTXLEN, pk)) {
+      fprintf(stderr, "Incremental verification failed\n");
+      return -1;
+    }
+
+    /* External mu signing interoperates with the pure mode */
+    crypto_sign_compute_mu(mu, m, MLEN, ctx, CTXLEN, pk);
+    crypto_sign_signature_extmu(sig2, &siglen, mu, sk);
+    if(siglen != CRYPTO_BYTES || crypto_sign_verify(sig2, siglen, m, MLEN, ctx, CTXLEN, pk)) {
+      fprintf(stderr, "Verification of external mu signature failed\n");
+      return -1;
+    }
+    if(crypto_sign_verify_extmu(sig, CRYPTO_BYTES, mu, pk)) {
+      fprintf(stderr, "External mu verification failed\n");
+      return -1;
+    }
+
+    /* Scatter-gather signing over three segments, one of them empty */
+    iov[0].base = m;
+    iov[0].len = k;
+    iov[1].base = m + k;
+    iov[1].len = 0;
+    iov[2].base = m + k;
+    iov[2].len = MLEN - k;
+    crypto_sign_signature_iov(sig2, &siglen, iov, 3, ctx, CTXLEN, sk);
+    if(siglen != CRYPTO_BYTES || crypto_sign_verify(sig2, siglen, m, MLEN, ctx, CTXLEN, pk)) {
+      fprintf(stderr, "Verification of scatter-gather signature failed\n");
+      return -1;
+    }
+    if(crypto_sign_verify_iov(sig, CRYPTO_BYTES, iov, 3, ctx, CTXLEN, pk)) {
+      fprintf(stderr, "Scatter-gather verification failed\n");
+      return -1;
+    }
+
+    /* Malformed hints are rejected before the message is absorbed */
+    sig[CRYPTO_BYTES - 1] = 0xFF;
+    if(!crypto_sign_verify_init(&vst, sig, CRYPTO_BYTES, ctx, CTXLEN, pk)) {
+      fprintf(stderr, "Incremental verification accepted malformed hints\n");
+      return -1;
+    }
+
+    randombytes((uint8_t *)&j, sizeof(j));
+    do {
+      randombytes(&b, 1);
+    } while(!b);
+    sm[j % (MLEN + CRYPTO_BYTES)] += b;
+    ret = crypto_sign_verify_expanded(sm, CRYPTO_BYTES, sm + CRYPTO_BYTES, MLEN, ctx, CTXLEN, &epk);
+    if(!ret) {
+      fprintf(stderr, "Trivial forgeries possible with expanded public key\n");
+      return -1;
+    }
+    ret = verify_streamed(sm, sm + CRYPTO_BYTES, MLEN, k, ctx, CTXLEN, pk);
+    if(!ret) {
+      fprintf(stderr, "Trivial forgeries possible with incremental verification\n");
+      return -1;
+    }
+    crypto_sign_compute_mu(mu, sm + CRYPTO_BYTES, MLEN, ctx, CTXLEN, pk);
+    if(!crypto_sign_verify_extmu(sm, CRYPTO_BYTES, mu, pk)) {
+      fprintf(stderr, "Trivial forgeries possible with external mu\n");
+      return -1;
+    }
+    iov[0].base = sm + CRYPTO_BYTES;
+    iov[0].len = k;
+    iov[1].base = sm + CRYPTO_BYTES + k;
+    iov[1].len = MLEN - k;
+    if(!crypto_sign_verify_iov(sm, CRYPTO_BYTES, iov, 2, ctx, CTXLEN, pk)) {
+      fprintf(stderr, "Trivial forgeries possible with scatter-gather verification\n");
+      return -1;
+    }
+    ret = crypto_sign_open_inplace(&mp, &mlen, sm, smlen, ctx, CTXLEN, pk);
+    if(!ret || mp || mlen) {
+      fprintf(stderr, "Trivial forgeries possible with in-place opening\n");
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int test_pkcache(const uint8_t *pre, size_t prelen)
+{
+  size_t i, j;
+  int ret;
+  uint8_t b;
+  uint8_t m[MLEN];
+  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
+  uint8_t sk[CRYPTO_SECRETKEYBYTES];
+  uint8_t sig[CRYPTO_BYTES];
+  uint8_t rnd[RNDBYTES] = {0};
+  size_t siglen;
+  pkcache_stats before, after;
+
+  /* Room for two cached public keys */
+  if(pkcache_set_capacity(3*sizeof(expanded_pk))) {
+    fprintf(stderr, "Public key cache allocation failed\n");
+    return -1;
+  }
+  pkcache_get_stats(&before);
+
+  for(i = 0; i < NCACHE; ++i) {
+    randombytes(m, MLEN);
+    crypto_sign_keypair(pk, sk);
+    crypto_sign_signature_internal(sig, &siglen, m, MLEN, pre, prelen, rnd, sk);
+
+    /* First lookup misses, second one hits */
+    for(j = 0; j < 2; ++j) {
+      if(crypto_sign_verify_cached_internal(sig, siglen, m, MLEN, pre, prelen, pk)) {
+        fprintf(stderr, "Verification with cached public key failed\n");
+        return -1;
+      }
+    }
+
+    randombytes((uint8_t *)&j, sizeof(j));
+    do {
+      randombytes(&b, 1);
+    } while(!b);
+    sig[j % CRYPTO_BYTES] += b;
+    ret = crypto_sign_verify_cached_internal(sig, siglen, m, MLEN, pre, prelen, pk);
+    if(!ret) {
+      fprintf(stderr, "Trivial forgeries possible with cached public key\n");
+      return -1;
+    }
+  }
+
+  pkcache_get_stats(&after);
+  if(after.hits - before.hits != 2*NCACHE || after.misses - before.misses != NCACHE
+     || after.evictions - before.evictions != NCACHE - 2) {
+    fprintf(stderr, "Public key cache counters wrong\n");
+    return -1;
+  }
+
+  return 0;
+}
 
 int main(void)
 {
@@ -15,6 +524,7 @@ int main(void)
   size_t mlen, smlen;
   uint8_t b;
   uint8_t ctx[CTXLEN] = {0};
+  uint8_t pre[2 + CTXLEN];
   uint8_t m[MLEN + CRYPTO_BYTES];
   uint8_t m2[MLEN + CRYPTO_BYTES];
   uint8_t sm[MLEN + CRYPTO_BYTES];
@@ -22,6 +532,10 @@ int main(void)
   uint8_t sk[CRYPTO_SECRETKEYBYTES];
 
   snprintf((char*)ctx,CTXLEN,"test_dilitium");
+  pre[0] = 0;
+  pre[1] = CTXLEN;
+  for(j = 0; j < CTXLEN; ++j)
+    pre[2 + j] = ctx[j];
 
   for(i = 0; i < NTESTS; ++i) {
     randombytes(m, MLEN);
@@ -61,6 +575,9 @@ int main(void)
     }
   }
 
+  if(test_keygen() || test_batch(ctx, pre, sizeof(pre)) || test_api(ctx) || test_pkcache(pre, sizeof(pre)))
+    return -1;
+
   printf("CRYPTO_PUBLICKEYBYTES = %d\n", CRYPTO_PUBLICKEYBYTES);
   printf("CRYPTO_SECRETKEYBYTES = %d\n", CRYPTO_SECRETKEYBYTES);
   printf("CRYPTO_BYTES = %d\n", CRYPTO_BYTES);
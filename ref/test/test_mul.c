@@ -23,11 +23,16 @@ static void poly_naivemul(poly *c, const poly *a, const poly *b) {
 
 int main(void) {
   unsigned int i, j;
+  int ret = 0;
   uint8_t seed[SEEDBYTES];
+  uint8_t rhoprime[CRHBYTES];
+  uint8_t cseed[CTILDEBYTES];
   uint16_t nonce = 0;
   poly a, b, c, d;
+  sparse_poly sc;
 
   randombytes(seed, sizeof(seed));
+  randombytes(rhoprime, sizeof(rhoprime));
   for(i = 0; i < NTESTS; ++i) {
     poly_uniform(&a, seed, nonce++);
     poly_uniform(&b, seed, nonce++);
@@ -38,9 +43,11 @@ int main(void) {
       c.coeffs[j] = (int64_t)c.coeffs[j]*-114592 % Q;
     poly_invntt_tomont(&c);
     for(j = 0; j < N; ++j) {
-      if((c.coeffs[j] - a.coeffs[j]) % Q)
+      if((c.coeffs[j] - a.coeffs[j]) % Q) {
         fprintf(stderr, "ERROR in ntt/invntt: c[%d] = %d != %d\n",
                 j, c.coeffs[j]%Q, a.coeffs[j]);
+        ret = 1;
+      }
     }
 
     poly_naivemul(&c, &a, &b);
@@ -50,11 +57,39 @@ int main(void) {
     poly_invntt_tomont(&d);
 
     for(j = 0; j < N; ++j) {
-      if((d.coeffs[j] - c.coeffs[j]) % Q)
+      if((d.coeffs[j] - c.coeffs[j]) % Q) {
         fprintf(stderr, "ERROR in multiplication: d[%d] = %d != %d\n",
                 j, d.coeffs[j], c.coeffs[j]);
+        ret = 1;
+      }
+    }
+
+    randombytes(cseed, sizeof(cseed));
+    poly_challenge(&b, cseed);
+    poly_challenge_sparse(&sc, &b);
+#ifdef poly_sparse_mul_eta
+    /* AVX2 build: product with short polynomial as in signing */
+    poly_uniform_eta(&a, rhoprime, nonce++);
+    poly_sparse_mul_eta(&d, &sc, &a);
+    c = a;
+    poly_ntt(&b);
+    poly_ntt(&c);
+    poly_pointwise_montgomery(&c, &b, &c);
+    poly_invntt_tomont(&c);
+#else
+    poly_uniform(&a, seed, nonce++);
+    poly_naivemul(&c, &a, &b);
+    poly_sparse_mul(&d, &sc, &a);
+#endif
+
+    for(j = 0; j < N; ++j) {
+      if((d.coeffs[j] - c.coeffs[j]) % Q) {
+        fprintf(stderr, "ERROR in sparse multiplication: d[%d] = %d != %d\n",
+                j, d.coeffs[j], c.coeffs[j]);
+        ret = 1;
+      }
     }
   }
 
-  return 0;
+  return ret;
 }
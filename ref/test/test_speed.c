@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include "../sign.h"
+#include "../signpool.h"
 #include "../poly.h"
 #include "../polyvec.h"
 #include "../params.h"
@@ -7,6 +8,8 @@
 #include "speed_print.h"
 
 #define NTESTS 1000
+#define SIGNBATCH 16
+#define SIGNTHREADS 3
 
 uint64_t t[NTESTS];
 
@@ -17,7 +20,26 @@ int main(void)
   uint8_t pk[CRYPTO_PUBLICKEYBYTES];
   uint8_t sk[CRYPTO_SECRETKEYBYTES];
   uint8_t sig[CRYPTO_BYTES];
+  uint8_t pks[4][CRYPTO_PUBLICKEYBYTES];
+  uint8_t sks[4][CRYPTO_SECRETKEYBYTES];
+  uint8_t *pkp[4] = {pks[0], pks[1], pks[2], pks[3]};
+  uint8_t *skp[4] = {sks[0], sks[1], sks[2], sks[3]};
+  const uint8_t *bsig[4] = {sig, sig, sig, sig};
+  const uint8_t *bm[4] = {sig, sig, sig, sig};
+  const uint8_t *bctx[4] = {NULL, NULL, NULL, NULL};
+  const uint8_t *bpk[4] = {pk, pk, pk, pk};
+  size_t bsiglen[4] = {CRYPTO_BYTES, CRYPTO_BYTES, CRYPTO_BYTES, CRYPTO_BYTES};
+  size_t bmlen[4] = {CRHBYTES, CRHBYTES, CRHBYTES, CRHBYTES};
+  size_t bctxlen[4] = {0, 0, 0, 0};
+  int bret[4];
+  uint8_t bsigs[SIGNBATCH][CRYPTO_BYTES];
+  uint8_t *bsigo[SIGNBATCH];
+  const uint8_t *bmsg[SIGNBATCH];
+  size_t bsiglens[SIGNBATCH], bmlens[SIGNBATCH];
   uint8_t seed[CRHBYTES];
+  expanded_sk esk;
+  signpool *spool;
+  expanded_pk epk;
   polyvecl mat[K];
   poly *a = &mat[0].vec[0];
   poly *b = &mat[0].vec[1];
@@ -65,23 +87,84 @@ int main(void)
   }
   print_results("poly_challenge:", t, NTESTS);
 
+  dbench_reset();
   for(i = 0; i < NTESTS; ++i) {
     t[i] = cpucycles();
     crypto_sign_keypair(pk, sk);
   }
   print_results("Keypair:", t, NTESTS);
+  print_dbench("Keypair (by primitive):", NTESTS);
 
+  for(i = 0; i < NTESTS; ++i) {
+    t[i] = cpucycles();
+    crypto_sign_keypair_x4(pkp, skp);
+  }
+  print_results("Keypair (4x):", t, NTESTS);
+
+  dbench_reset();
   for(i = 0; i < NTESTS; ++i) {
     t[i] = cpucycles();
     crypto_sign_signature(sig, &siglen, sig, CRHBYTES, NULL, 0, sk);
   }
   print_results("Sign:", t, NTESTS);
+  print_dbench("Sign (by primitive):", NTESTS);
+
+  for(i = 0; i < NTESTS; ++i) {
+    t[i] = cpucycles();
+    crypto_sign_expand_sk(&esk, sk);
+  }
+  print_results("Expand sk:", t, NTESTS);
+
+  for(i = 0; i < NTESTS; ++i) {
+    t[i] = cpucycles();
+    crypto_sign_signature_expanded(sig, &siglen, sig, CRHBYTES, NULL, 0, &esk);
+  }
+  print_results("Sign (expanded sk):", t, NTESTS);
+
+  for(i = 0; i < SIGNBATCH; ++i) {
+    bsigo[i] = bsigs[i];
+    bmsg[i] = sig;
+    bmlens[i] = CRHBYTES;
+  }
+  for(i = 0; i < NTESTS; ++i) {
+    t[i] = cpucycles();
+    crypto_sign_signature_batch(bsigo, bsiglens, bmsg, bmlens, NULL, 0, sk, SIGNBATCH);
+  }
+  print_results("Sign (16x batch):", t, NTESTS);
 
+  spool = signpool_create(SIGNTHREADS);
+  for(i = 0; i < NTESTS; ++i) {
+    t[i] = cpucycles();
+    crypto_sign_signature_parallel(sig, &siglen, sig, CRHBYTES, NULL, 0, &esk, spool);
+  }
+  print_results("Sign (parallel):", t, NTESTS);
+  signpool_destroy(spool);
+
+  dbench_reset();
   for(i = 0; i < NTESTS; ++i) {
     t[i] = cpucycles();
     crypto_sign_verify(sig, CRYPTO_BYTES, sig, CRHBYTES, NULL, 0, pk);
   }
   print_results("Verify:", t, NTESTS);
+  print_dbench("Verify (by primitive):", NTESTS);
+
+  for(i = 0; i < NTESTS; ++i) {
+    t[i] = cpucycles();
+    crypto_sign_expand_pk(&epk, pk);
+  }
+  print_results("Expand pk:", t, NTESTS);
+
+  for(i = 0; i < NTESTS; ++i) {
+    t[i] = cpucycles();
+    crypto_sign_verify_expanded(sig, CRYPTO_BYTES, sig, CRHBYTES, NULL, 0, &epk);
+  }
+  print_results("Verify (expanded pk):", t, NTESTS);
+
+  for(i = 0; i < NTESTS; ++i) {
+    t[i] = cpucycles();
+    crypto_sign_verify_batch(bret, bsig, bsiglen, bm, bmlen, bctx, bctxlen, bpk, 4);
+  }
+  print_results("Verify (4x batch):", t, NTESTS);
 
   return 0;
 }
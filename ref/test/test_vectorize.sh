@@ -0,0 +1,54 @@
+#!/bin/sh -e
+# Checks that the compiler vectorizes the arithmetic kernels in poly.c for
+# every SIMD target of the host architecture. Works with GCC and Clang; set
+# CC, VECFLAGS and VECTARGETS to check other compilers or targets.
+
+CC="${CC:-cc}"
+VECFLAGS="${VECFLAGS:--O3}"
+KERNELS="poly_reduce poly_caddq poly_add poly_sub poly_shiftl
+  poly_pointwise_montgomery poly_power2round poly_decompose poly_make_hint
+  poly_use_hint poly_chknorm"
+
+if [ -z "$VECTARGETS" ]; then
+  case "$(uname -m)" in
+    x86_64|amd64) VECTARGETS="-msse2 -msse4.1 -mavx2" ;;
+    aarch64|arm64) VECTARGETS="-march=armv8-a -march=armv8-a+sve" ;;
+    riscv64) VECTARGETS="-march=rv64gcv" ;;
+    *) VECTARGETS="-march=native" ;;
+  esac
+fi
+
+cd "$(dirname "$0")/.."
+if $CC --version | grep -q clang; then
+  REPORT="-Rpass=loop-vectorize"
+else
+  REPORT="-fopt-info-vec-optimized"
+fi
+
+LOG=$(mktemp)
+trap 'rm -f "$LOG"' EXIT
+FAIL=0
+for target in $VECTARGETS; do
+  case "$target" in
+    # SSE2 has no signed 32x32->64 bit multiplication, so the Montgomery
+    # multiplication in poly_pointwise_montgomery stays scalar
+    -msse2) SCALAR="poly_pointwise_montgomery" ;;
+    *) SCALAR="" ;;
+  esac
+  for alg in 2 3 5; do
+    $CC $VECFLAGS $target $REPORT -DDILITHIUM_MODE=$alg -c poly.c -o /dev/null 2> "$LOG"
+    LINES=$(grep 'loop vectorized\|vectorized loop' "$LOG" | cut -d: -f2)
+    for k in $KERNELS; do
+      case " $SCALAR " in *" $k "*) continue ;; esac
+      START=$(grep -n "^[a-z].*[ *]$k(" poly.c | cut -d: -f1)
+      END=$(awk -v s="$START" 'NR > s && /^}/ { print NR; exit }' poly.c)
+      if ! echo "$LINES" | awk -v s="$START" -v e="$END" \
+           '$1 > s && $1 < e { f = 1 } END { exit !f }'; then
+        echo "$k not vectorized for Dilithium$alg with $target"
+        FAIL=1
+      fi
+    done
+  done
+done
+
+exit $FAIL
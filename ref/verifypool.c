@@ -0,0 +1,301 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "params.h"
+#include "sign.h"
+#include "verifypool.h"
+
+/* Fixed pool of verification threads. Submitted jobs are spread round
+ * robin over bounded per-worker deques; a worker takes the oldest job of
+ * its own deque and, when that is empty, steals the newest job of another
+ * worker. Each worker owns an expanded public key as workspace, which it
+ * reuses as long as consecutive jobs carry the same public key, so the
+ * hot path never allocates and the matrix A never lives on the stack. */
+
+typedef struct {
+  pthread_mutex_t lock;
+  size_t head;
+  size_t tail;
+  verifypool_job *jobs[VERIFYPOOL_DEQUE_SIZE];
+} deque;
+
+typedef struct {
+  expanded_pk epk;
+  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
+  int haspk;
+  unsigned int id;
+  deque dq;
+  verifypool *pool;
+  pthread_t thread;
+} worker;
+
+struct verifypool {
+  worker *workers;
+  unsigned int nworkers;
+  unsigned int nthreads;
+  atomic_uint next;
+  atomic_size_t pending;
+  atomic_uint sleeping;
+  int stop;
+  pthread_mutex_t lock;
+  pthread_cond_t work;
+  pthread_mutex_t donelock;
+  pthread_cond_t done;
+};
+
+static int deque_push(deque *dq, verifypool_job *job) {
+  int ret = -1;
+
+  pthread_mutex_lock(&dq->lock);
+  if(dq->tail - dq->head < VERIFYPOOL_DEQUE_SIZE) {
+    dq->jobs[dq->tail++ % VERIFYPOOL_DEQUE_SIZE] = job;
+    ret = 0;
+  }
+  pthread_mutex_unlock(&dq->lock);
+  return ret;
+}
+
+static verifypool_job *deque_pop(deque *dq) {
+  verifypool_job *job = NULL;
+
+  pthread_mutex_lock(&dq->lock);
+  if(dq->head != dq->tail)
+    job = dq->jobs[dq->head++ % VERIFYPOOL_DEQUE_SIZE];
+  pthread_mutex_unlock(&dq->lock);
+  return job;
+}
+
+static verifypool_job *deque_steal(deque *dq) {
+  verifypool_job *job = NULL;
+
+  pthread_mutex_lock(&dq->lock);
+  if(dq->head != dq->tail)
+    job = dq->jobs[--dq->tail % VERIFYPOOL_DEQUE_SIZE];
+  pthread_mutex_unlock(&dq->lock);
+  return job;
+}
+
+static void complete(verifypool *pool, verifypool_job *job) {
+  /* The pool does not touch callback jobs after the callback */
+  if(job->callback) {
+    job->callback(job);
+    return;
+  }
+
+  pthread_mutex_lock(&pool->donelock);
+  atomic_store_explicit(&job->done, 1, memory_order_release);
+  pthread_cond_broadcast(&pool->done);
+  pthread_mutex_unlock(&pool->donelock);
+}
+
+static void run(worker *w, verifypool_job *job) {
+  if(!w->haspk || memcmp(w->pk, job->pk, CRYPTO_PUBLICKEYBYTES)) {
+    crypto_sign_expand_pk(&w->epk, job->pk);
+    memcpy(w->pk, job->pk, CRYPTO_PUBLICKEYBYTES);
+    w->haspk = 1;
+  }
+
+  job->result = crypto_sign_verify_expanded(job->sig, job->siglen, job->m, job->mlen,
+                                            job->ctx, job->ctxlen, &w->epk);
+  complete(w->pool, job);
+}
+
+static void *worker_main(void *arg) {
+  unsigned int i;
+  worker *w = arg;
+  verifypool *pool = w->pool;
+  verifypool_job *job;
+
+  for(;;) {
+    job = deque_pop(&w->dq);
+    for(i = 1; !job && i < pool->nworkers; ++i)
+      job = deque_steal(&pool->workers[(w->id + i) % pool->nworkers].dq);
+
+    if(job) {
+      atomic_fetch_sub(&pool->pending, 1);
+      run(w, job);
+      continue;
+    }
+
+    /* Sleep until work is submitted; pending jobs are drained on stop */
+    pthread_mutex_lock(&pool->lock);
+    atomic_fetch_add(&pool->sleeping, 1);
+    while(!atomic_load(&pool->pending) && !pool->stop)
+      pthread_cond_wait(&pool->work, &pool->lock);
+    atomic_fetch_sub(&pool->sleeping, 1);
+    if(pool->stop && !atomic_load(&pool->pending)) {
+      pthread_mutex_unlock(&pool->lock);
+      break;
+    }
+    pthread_mutex_unlock(&pool->lock);
+  }
+
+  return NULL;
+}
+
+/*************************************************
+* Name:        verifypool_create
+*
+* Description: Starts pool of verification threads. All workspace of the
+*              workers is allocated here.
+*
+* Arguments:   - unsigned int nthreads: number of worker threads (at least 1)
+*
+* Returns pointer to pool or NULL on failure
+**************************************************/
+verifypool *verifypool_create(unsigned int nthreads) {
+  unsigned int i;
+  size_t bytes;
+  pthread_attr_t attr;
+  verifypool *pool;
+
+  if(nthreads == 0)
+    return NULL;
+
+  pool = calloc(1, sizeof(verifypool));
+  if(!pool)
+    return NULL;
+
+  bytes = (nthreads*sizeof(worker) + 63) & ~(size_t)63;
+  pool->workers = aligned_alloc(64, bytes);
+  if(!pool->workers) {
+    free(pool);
+    return NULL;
+  }
+
+  memset(pool->workers, 0, bytes);
+  pool->nworkers = nthreads;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work, NULL);
+  pthread_mutex_init(&pool->donelock, NULL);
+  pthread_cond_init(&pool->done, NULL);
+
+  /* Deques must exist before the first worker starts stealing */
+  for(i = 0; i < nthreads; ++i) {
+    pool->workers[i].id = i;
+    pool->workers[i].pool = pool;
+    pthread_mutex_init(&pool->workers[i].dq.lock, NULL);
+  }
+
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, VERIFYPOOL_STACK_BYTES);
+  for(i = 0; i < nthreads; ++i) {
+    if(pthread_create(&pool->workers[i].thread, &attr, worker_main, &pool->workers[i]))
+      break;
+    pool->nthreads++;
+  }
+  pthread_attr_destroy(&attr);
+
+  if(pool->nthreads != nthreads) {
+    verifypool_destroy(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+/*************************************************
+* Name:        verifypool_destroy
+*
+* Description: Finishes all submitted jobs, stops the worker threads and
+*              frees the pool.
+*
+* Arguments:   - verifypool *pool: pointer to pool
+**************************************************/
+void verifypool_destroy(verifypool *pool) {
+  unsigned int i;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->work);
+  pthread_mutex_unlock(&pool->lock);
+
+  for(i = 0; i < pool->nthreads; ++i)
+    pthread_join(pool->workers[i].thread, NULL);
+
+  for(i = 0; i < pool->nworkers; ++i)
+    pthread_mutex_destroy(&pool->workers[i].dq.lock);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->work);
+  pthread_mutex_destroy(&pool->donelock);
+  pthread_cond_destroy(&pool->done);
+  free(pool->workers);
+  free(pool);
+}
+
+/*************************************************
+* Name:        verifypool_submit
+*
+* Description: Queues verification job. The job is completed either by
+*              calling job->callback from a worker thread, if it is not
+*              NULL, or by marking it done for verifypool_poll and
+*              verifypool_wait. The job must stay valid until then. If all
+*              deques are full the job is verified in the calling thread.
+*
+* Arguments:   - verifypool *pool: pointer to pool
+*              - verifypool_job *job: pointer to job with input fields set
+**************************************************/
+void verifypool_submit(verifypool *pool, verifypool_job *job) {
+  unsigned int i, start;
+
+  job->pool = pool;
+  atomic_store_explicit(&job->done, 0, memory_order_relaxed);
+
+  atomic_fetch_add(&pool->pending, 1);
+  start = atomic_fetch_add_explicit(&pool->next, 1, memory_order_relaxed);
+  for(i = 0; i < pool->nworkers; ++i)
+    if(!deque_push(&pool->workers[(start + i) % pool->nworkers].dq, job))
+      break;
+
+  if(i == pool->nworkers) {
+    atomic_fetch_sub(&pool->pending, 1);
+    job->result = crypto_sign_verify(job->sig, job->siglen, job->m, job->mlen,
+                                     job->ctx, job->ctxlen, job->pk);
+    complete(pool, job);
+    return;
+  }
+
+  if(atomic_load(&pool->sleeping)) {
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+  }
+}
+
+/*************************************************
+* Name:        verifypool_poll
+*
+* Description: Checks whether job without callback is done.
+*
+* Arguments:   - verifypool_job *job: pointer to submitted job
+*
+* Returns 1 if job is done and 0 otherwise
+**************************************************/
+int verifypool_poll(verifypool_job *job) {
+  return atomic_load_explicit(&job->done, memory_order_acquire);
+}
+
+/*************************************************
+* Name:        verifypool_wait
+*
+* Description: Blocks until job without callback is done.
+*
+* Arguments:   - verifypool_job *job: pointer to submitted job
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int verifypool_wait(verifypool_job *job) {
+  verifypool *pool = job->pool;
+
+  if(!atomic_load_explicit(&job->done, memory_order_acquire)) {
+    pthread_mutex_lock(&pool->donelock);
+    while(!atomic_load_explicit(&job->done, memory_order_acquire))
+      pthread_cond_wait(&pool->done, &pool->donelock);
+    pthread_mutex_unlock(&pool->donelock);
+  }
+
+  return job->result;
+}
@@ -0,0 +1,54 @@
+#ifndef VERIFYPOOL_H
+#define VERIFYPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "params.h"
+
+/* Jobs each worker can hold before submissions spill to other workers */
+#ifndef VERIFYPOOL_DEQUE_SIZE
+#define VERIFYPOOL_DEQUE_SIZE 256
+#endif
+
+/* Stack of worker threads; large buffers live in the worker workspace */
+#ifndef VERIFYPOOL_STACK_BYTES
+#define VERIFYPOOL_STACK_BYTES (1 << 18)
+#endif
+
+typedef struct verifypool verifypool;
+
+typedef struct verifypool_job {
+  /* Input, set by caller */
+  const uint8_t *sig;
+  size_t siglen;
+  const uint8_t *m;
+  size_t mlen;
+  const uint8_t *ctx;
+  size_t ctxlen;
+  const uint8_t *pk;
+  void (*callback)(struct verifypool_job *job);
+  void *arg;
+  /* Output, 0 if signature is valid and -1 otherwise */
+  int result;
+  /* Internal */
+  verifypool *pool;
+  atomic_int done;
+} verifypool_job;
+
+#define verifypool_create DILITHIUM_NAMESPACE(verifypool_create)
+verifypool *verifypool_create(unsigned int nthreads);
+
+#define verifypool_destroy DILITHIUM_NAMESPACE(verifypool_destroy)
+void verifypool_destroy(verifypool *pool);
+
+#define verifypool_submit DILITHIUM_NAMESPACE(verifypool_submit)
+void verifypool_submit(verifypool *pool, verifypool_job *job);
+
+#define verifypool_poll DILITHIUM_NAMESPACE(verifypool_poll)
+int verifypool_poll(verifypool_job *job);
+
+#define verifypool_wait DILITHIUM_NAMESPACE(verifypool_wait)
+int verifypool_wait(verifypool_job *job);
+
+#endif
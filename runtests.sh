@@ -15,7 +15,12 @@ if [ "$ARCH" = "amd64" -o "$ARCH" = "arm64" ]; then
   export CFLAGS="-fsanitize=undefined,address ${CFLAGS}"
 fi
 
-for dir in $DIRS; do
+if [ "$ARCH" = "amd64" -o "$ARCH" = "arm64" ]; then
+  ./ref/test/test_vectorize.sh
+fi
+
+run_tests() {
+  dir=$1
   make -j$(nproc) -C $dir clean
   make -j$(nproc) -C $dir
   for alg in 2 3 5; do
@@ -26,8 +31,22 @@ for dir in $DIRS; do
     ./$dir/test/test_vectors$alg > tvecs$alg &
     PID2=$!
     wait $PID1 $PID2
+    if [ "$dir" = "avx2" ]; then
+      ./$dir/test/test_mul$alg
+    fi
   done
   shasum -a256 -c SHA256SUMS
+}
+
+for dir in $DIRS; do
+  run_tests $dir
+  if [ "$dir" = "avx2" ]; then
+    # Again with the AVX-512 code paths disabled
+    SAVED_CFLAGS="${CFLAGS}"
+    export CFLAGS="-DDILITHIUM_NO_AVX512 ${CFLAGS}"
+    run_tests $dir
+    export CFLAGS="${SAVED_CFLAGS}"
+  fi
 done
 
 exit 0